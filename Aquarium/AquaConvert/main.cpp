@@ -0,0 +1,77 @@
+/**
+ * @file main.cpp
+ * @author joeyv
+ *
+ * Convert a tank between .aqua XML and the binary format.
+ *
+ * Usage: AquaConvert input output
+ *
+ * The input may be in either format. The output is binary
+ * if its name ends in .aquab and XML otherwise. The items
+ * are converted as plain data, so no images are loaded.
+ */
+
+#include <pch.h>
+#include <TankFile.h>
+#include <wx/filename.h>
+#include <chrono>
+#include <cstdio>
+
+using namespace std;
+
+/**
+ * Seconds since a starting time
+ * @param start Starting time
+ * @return Elapsed seconds
+ */
+static double SecondsSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s input output\n", argv[0]);
+        return 1;
+    }
+
+    wxInitializer initializer;
+    if (!initializer.IsOk())
+    {
+        fprintf(stderr, "Unable to initialize wxWidgets\n");
+        return 1;
+    }
+
+    wxString input(argv[1]);
+    wxString output(argv[2]);
+
+    if (!wxFileName::FileExists(input))
+    {
+        fprintf(stderr, "Unable to open %s\n", argv[1]);
+        return 1;
+    }
+
+    TankData data;
+
+    auto start = chrono::steady_clock::now();
+    if (!TankFile::Read(input, data))
+    {
+        fprintf(stderr, "Unable to read %s\n", argv[1]);
+        return 1;
+    }
+    printf("read: %zu items in %.1f ms\n", data.items.size(), SecondsSince(start) * 1000);
+
+    auto format = output.Lower().EndsWith(L".aquab") ? TankFile::Format::Binary : TankFile::Format::Xml;
+
+    start = chrono::steady_clock::now();
+    if (!TankFile::Write(output, data, format))
+    {
+        fprintf(stderr, "Unable to write %s\n", argv[2]);
+        return 1;
+    }
+    printf("write: %.1f ms\n", SecondsSince(start) * 1000);
+
+    return 0;
+}
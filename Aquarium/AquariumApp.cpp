@@ -4,6 +4,9 @@
  */
 #include "pch.h"
 #include <MainFrame.h>
+#include <Aquarium.h>
+#include <ImagePreloader.h>
+#include <wx/stdpaths.h>
 #include "AquariumApp.h"
 
 #ifdef WIN32
@@ -28,6 +31,12 @@
     // Add image type handlers
     wxInitAllImageHandlers();
 
+    // Decode the images while the frame is built, so the first
+    // items added or loaded never wait for the disk. Images
+    // decoded on an earlier run come from the image cache.
+    auto cache = wxStandardPaths::Get().GetUserLocalDataDir() + L"/images";
+    ImagePreloader::Instance().Start(Aquarium::GetImageFiles(), cache.ToStdWstring());
+
      auto frame = new MainFrame();
      frame->Initialize();
      frame->Show(true);
@@ -0,0 +1,66 @@
+/**
+ * @file AquaBinary.h
+ * @author joeyv
+ *
+ * Layout of the binary tank format.
+ *
+ * A binary tank file holds the same items as a .aqua XML
+ * file, but as fixed width records that are loaded without
+ * parsing any text. All values are little-endian.
+ *
+ * Header, 32 bytes:
+ *  - 8 bytes  magic, "AQUABIN" and a zero byte
+ *  - uint32   format version, currently 1
+ *  - uint32   size of each item record in bytes
+ *  - uint32   number of species
+ *  - uint32   reserved, zero
+ *  - uint64   number of items
+ *
+ * Species table, for each species:
+ *  - uint32   length of the type tag in bytes
+ *  - bytes    the type tag, as in the XML type attribute
+ *
+ * then zero padding to a multiple of 8 bytes.
+ *
+ * Item records, in drawing order from back to front:
+ *  - double   x location
+ *  - double   y location
+ *  - double   x speed
+ *  - double   y speed
+ *  - uint32   index of the species in the species table
+ *  - uint32   reserved, zero
+ *
+ * Readers skip any record bytes past the fields they know,
+ * so later versions can add fields to the end of a record.
+ */
+
+#ifndef AQUARIUM_AQUABINARY_H
+#define AQUARIUM_AQUABINARY_H
+
+#include <cstdint>
+#include <cstring>
+
+/// First bytes of every binary tank file
+const char AquaBinaryMagic[8] = {'A', 'Q', 'U', 'A', 'B', 'I', 'N', 0};
+
+/// Format version this code writes
+const uint32_t AquaBinaryVersion = 1;
+
+/// Size of the file header in bytes
+const size_t AquaBinaryHeaderSize = 32;
+
+/// Size of the item records this code writes
+const size_t AquaBinaryRecordSize = 40;
+
+/**
+ * One item of a binary tank file
+ */
+struct AquaBinaryRecord {
+    double x = 0;           ///< X location
+    double y = 0;           ///< Y location
+    double speedX = 0;      ///< X speed in pixels per second
+    double speedY = 0;      ///< Y speed in pixels per second
+    uint32_t species = 0;   ///< Index in the species table
+};
+
+#endif //AQUARIUM_AQUABINARY_H
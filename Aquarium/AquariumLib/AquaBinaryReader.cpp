@@ -0,0 +1,123 @@
+/**
+ * @file AquaBinaryReader.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "AquaBinaryReader.h"
+
+using namespace std;
+
+/**
+ * Decode a little-endian 32 bit integer
+ * @param data First byte
+ * @return The integer
+ */
+static uint32_t ReadUInt32(const char *data)
+{
+    auto bytes = (const uint8_t *)data;
+    return (uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 |
+            (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+}
+
+/**
+ * Decode a little-endian 64 bit integer
+ * @param data First byte
+ * @return The integer
+ */
+static uint64_t ReadUInt64(const char *data)
+{
+    return (uint64_t)ReadUInt32(data) | (uint64_t)ReadUInt32(data + 4) << 32;
+}
+
+/**
+ * Decode a little-endian double
+ * @param data First byte
+ * @return The double
+ */
+static double ReadDouble(const char *data)
+{
+    auto bits = ReadUInt64(data);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * Constructor
+ *
+ * Maps the file and reads the header and species table.
+ * @param filename File to read
+ */
+AquaBinaryReader::AquaBinaryReader(const wxString &filename) : mFile(filename)
+{
+    auto data = mFile.GetData();
+    auto size = mFile.GetSize();
+    if (size < sizeof(AquaBinaryMagic) || memcmp(data, AquaBinaryMagic, sizeof(AquaBinaryMagic)) != 0)
+    {
+        return;
+    }
+
+    mBinary = true;
+    mError = true;
+
+    if (size < AquaBinaryHeaderSize || ReadUInt32(data + 8) != AquaBinaryVersion)
+    {
+        return;
+    }
+
+    mRecordSize = ReadUInt32(data + 12);
+    auto speciesCount = ReadUInt32(data + 16);
+    auto count = ReadUInt64(data + 24);
+    if (mRecordSize < AquaBinaryRecordSize)
+    {
+        return;
+    }
+
+    size_t offset = AquaBinaryHeaderSize;
+    for (uint32_t i = 0; i < speciesCount; i++)
+    {
+        if (size - offset < 4)
+        {
+            return;
+        }
+
+        auto length = ReadUInt32(data + offset);
+        offset += 4;
+        if (size - offset < length)
+        {
+            return;
+        }
+
+        mSpecies.emplace_back(data + offset, length);
+        offset += length;
+    }
+
+    offset = (offset + 7) & ~(size_t)7;
+    if (offset > size || (size - offset) / mRecordSize < count)
+    {
+        return;
+    }
+
+    mRecords = data + offset;
+    mCount = (size_t)count;
+    mError = false;
+}
+
+/**
+ * Decode an item record
+ * @param index Index of the item, 0 is the back
+ * @return The item record
+ */
+AquaBinaryRecord AquaBinaryReader::GetRecord(size_t index) const
+{
+    auto data = mRecords + index * mRecordSize;
+
+    AquaBinaryRecord record;
+    record.x = ReadDouble(data);
+    record.y = ReadDouble(data + 8);
+    record.speedX = ReadDouble(data + 16);
+    record.speedY = ReadDouble(data + 24);
+    record.species = ReadUInt32(data + 32);
+    return record;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file AquaBinaryReader.h
+ * @author joeyv
+ *
+ * Reader for binary tank files.
+ */
+
+#ifndef AQUARIUM_AQUABINARYREADER_H
+#define AQUARIUM_AQUABINARYREADER_H
+
+#include <string_view>
+#include <vector>
+
+#include "AquaBinary.h"
+#include "MappedFile.h"
+
+/**
+ * Reader for binary tank files.
+ *
+ * The file is mapped into memory and records are decoded
+ * from the mapping as they are asked for, so opening a
+ * file only reads its header and species table.
+ */
+class AquaBinaryReader {
+private:
+    /// The file we are reading
+    MappedFile mFile;
+
+    /// True if the file starts with AquaBinaryMagic
+    bool mBinary = false;
+
+    /// True if the file is binary but cannot be read
+    bool mError = false;
+
+    /// Type tags of the species, pointing into the mapping
+    std::vector<std::string_view> mSpecies;
+
+    /// First item record
+    const char *mRecords = nullptr;
+
+    /// Size of each item record in bytes
+    size_t mRecordSize = 0;
+
+    /// Number of item records
+    size_t mCount = 0;
+
+public:
+    explicit AquaBinaryReader(const wxString &filename);
+
+    /// Default constructor (disabled)
+    AquaBinaryReader() = delete;
+
+    /// Copy constructor (disabled)
+    AquaBinaryReader(const AquaBinaryReader &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const AquaBinaryReader &) = delete;
+
+    /**
+     * Is this a binary tank file?
+     * @return true if the file starts with the binary format magic
+     */
+    bool IsBinary() const { return mBinary; }
+
+    /**
+     * Is the file damaged or of an unknown version?
+     * @return true if the items cannot be read
+     */
+    bool HasError() const { return mError; }
+
+    /**
+     * Get the number of species in the species table
+     * @return Species count
+     */
+    size_t GetSpeciesCount() const { return mSpecies.size(); }
+
+    /**
+     * Get the type tag of a species
+     * @param species Index in the species table
+     * @return Type tag, as in the XML type attribute
+     */
+    std::string_view GetSpecies(size_t species) const { return mSpecies[species]; }
+
+    /**
+     * Get the number of items
+     * @return Item count
+     */
+    size_t GetCount() const { return mCount; }
+
+    AquaBinaryRecord GetRecord(size_t index) const;
+};
+
+#endif //AQUARIUM_AQUABINARYREADER_H
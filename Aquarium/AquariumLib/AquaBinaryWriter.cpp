@@ -0,0 +1,162 @@
+/**
+ * @file AquaBinaryWriter.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "AquaBinaryWriter.h"
+
+using namespace std;
+
+/// Size of the write buffer in bytes
+const size_t BufferSize = 64 * 1024;
+
+/**
+ * Constructor
+ * @param filename File to create
+ * @param species Type tags of the species table
+ * @param count Number of records that will be added
+ */
+AquaBinaryWriter::AquaBinaryWriter(const wxString &filename, const std::vector<std::string_view> &species,
+        size_t count) : mBuffer(BufferSize), mCount(count)
+{
+    if (!mFile.Open(filename, wxFile::write))
+    {
+        return;
+    }
+
+    Write(AquaBinaryMagic, sizeof(AquaBinaryMagic));
+    WriteUInt32(AquaBinaryVersion);
+    WriteUInt32((uint32_t)AquaBinaryRecordSize);
+    WriteUInt32((uint32_t)species.size());
+    WriteUInt32(0);
+    WriteUInt64(count);
+
+    size_t offset = AquaBinaryHeaderSize;
+    for (auto type : species)
+    {
+        WriteUInt32((uint32_t)type.size());
+        Write(type.data(), type.size());
+        offset += 4 + type.size();
+    }
+
+    // Records start on a multiple of 8 bytes
+    const char padding[8] = {};
+    Write(padding, (8 - offset % 8) % 8);
+}
+
+/**
+ * Destructor, finishes the file if Close was not called
+ */
+AquaBinaryWriter::~AquaBinaryWriter()
+{
+    Close();
+}
+
+/**
+ * Add bytes to the output
+ * @param data First byte
+ * @param size Number of bytes
+ */
+void AquaBinaryWriter::Write(const void *data, size_t size)
+{
+    auto bytes = (const char *)data;
+    while (size > 0)
+    {
+        if (mUsed == mBuffer.size())
+        {
+            Flush();
+        }
+
+        auto count = min(size, mBuffer.size() - mUsed);
+        memcpy(mBuffer.data() + mUsed, bytes, count);
+        mUsed += count;
+        bytes += count;
+        size -= count;
+    }
+}
+
+/**
+ * Add a little-endian 32 bit integer to the output
+ * @param value Value to add
+ */
+void AquaBinaryWriter::WriteUInt32(uint32_t value)
+{
+    uint8_t bytes[4];
+    for (int i = 0; i < 4; i++)
+    {
+        bytes[i] = (uint8_t)(value >> (i * 8));
+    }
+
+    Write(bytes, sizeof(bytes));
+}
+
+/**
+ * Add a little-endian 64 bit integer to the output
+ * @param value Value to add
+ */
+void AquaBinaryWriter::WriteUInt64(uint64_t value)
+{
+    WriteUInt32((uint32_t)value);
+    WriteUInt32((uint32_t)(value >> 32));
+}
+
+/**
+ * Add a little-endian double to the output
+ * @param value Value to add
+ */
+void AquaBinaryWriter::WriteDouble(double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    WriteUInt64(bits);
+}
+
+/**
+ * Write the buffer to the file
+ */
+void AquaBinaryWriter::Flush()
+{
+    if (mUsed > 0 && mFile.IsOpened() && mFile.Write(mBuffer.data(), mUsed) != mUsed)
+    {
+        mError = true;
+    }
+
+    mUsed = 0;
+}
+
+/**
+ * Add the record of the next item
+ * @param record Item record
+ */
+void AquaBinaryWriter::Add(const AquaBinaryRecord &record)
+{
+    WriteDouble(record.x);
+    WriteDouble(record.y);
+    WriteDouble(record.speedX);
+    WriteDouble(record.speedY);
+    WriteUInt32(record.species);
+    WriteUInt32(0);
+    mWritten++;
+}
+
+/**
+ * Finish the file
+ * @return true if the whole file was written with
+ * as many records as the header promises
+ */
+bool AquaBinaryWriter::Close()
+{
+    if (!mFile.IsOpened())
+    {
+        return false;
+    }
+
+    Flush();
+    if (!mFile.Close())
+    {
+        mError = true;
+    }
+
+    return !mError && mWritten == mCount;
+}
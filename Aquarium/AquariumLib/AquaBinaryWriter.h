@@ -0,0 +1,72 @@
+/**
+ * @file AquaBinaryWriter.h
+ * @author joeyv
+ *
+ * Writer for binary tank files.
+ */
+
+#ifndef AQUARIUM_AQUABINARYWRITER_H
+#define AQUARIUM_AQUABINARYWRITER_H
+
+#include <string_view>
+#include <vector>
+#include <wx/file.h>
+
+#include "AquaBinary.h"
+
+/**
+ * Writer for binary tank files.
+ *
+ * The header and species table are written when the writer
+ * is created, then each item record is added in drawing order.
+ */
+class AquaBinaryWriter {
+private:
+    /// The file we are writing
+    wxFile mFile;
+
+    /// Fixed size buffer of output not yet written to the file
+    std::vector<char> mBuffer;
+
+    /// Number of bytes used in mBuffer
+    size_t mUsed = 0;
+
+    /// True if a write to the file failed
+    bool mError = false;
+
+    /// Number of records the header promises
+    size_t mCount;
+
+    /// Number of records written so far
+    size_t mWritten = 0;
+
+    void Write(const void *data, size_t size);
+    void WriteUInt32(uint32_t value);
+    void WriteUInt64(uint64_t value);
+    void WriteDouble(double value);
+    void Flush();
+
+public:
+    AquaBinaryWriter(const wxString &filename, const std::vector<std::string_view> &species, size_t count);
+    virtual ~AquaBinaryWriter();
+
+    /// Default constructor (disabled)
+    AquaBinaryWriter() = delete;
+
+    /// Copy constructor (disabled)
+    AquaBinaryWriter(const AquaBinaryWriter &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const AquaBinaryWriter &) = delete;
+
+    /**
+     * Was the file created?
+     * @return true if the file can be written
+     */
+    bool IsOpen() const { return mFile.IsOpened(); }
+
+    void Add(const AquaBinaryRecord &record);
+    bool Close();
+};
+
+#endif //AQUARIUM_AQUABINARYWRITER_H
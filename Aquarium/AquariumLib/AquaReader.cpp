@@ -0,0 +1,430 @@
+/**
+ * @file AquaReader.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "AquaReader.h"
+#include "NumberText.h"
+#include <charconv>
+#include <cstring>
+
+using namespace std;
+
+/// Size of the read buffer in bytes. A single tag must fit in it.
+const size_t BufferSize = 64 * 1024;
+
+/**
+ * Determine if a character is XML white space
+ * @param c Character to test
+ * @return true if c is white space
+ */
+static inline bool IsSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/**
+ * Constructor
+ * @param filename File to read
+ */
+AquaReader::AquaReader(const wxString &filename) : mBuffer(BufferSize)
+{
+    mData = mBuffer.data();
+    if (mFile.Open(filename, wxFile::read))
+    {
+        auto length = mFile.Length();
+        mLength = length > 0 ? (size_t)length : 0;
+    }
+}
+
+/**
+ * Constructor for a fragment of a file already in memory.
+ *
+ * The fragment is parsed as if it came after the start
+ * tags of a number of elements. Running out of data inside
+ * an element is not an error, so GetOpen can be checked
+ * to see where the fragment ends.
+ *
+ * @param begin First byte of the fragment
+ * @param end End of the fragment
+ * @param open Number of elements the fragment starts inside of
+ */
+AquaReader::AquaReader(const char *begin, const char *end, int open) :
+        mData(begin), mEnd(end - begin), mLength(end - begin), mRead(end - begin),
+        mEof(true), mMemory(true), mOpen(open)
+{
+}
+
+/**
+ * Move the unparsed data to the front of the
+ * buffer and read more from the file after it
+ * @return false if no more data could be read
+ */
+bool AquaReader::Fill()
+{
+    if (mEof || !mFile.IsOpened())
+    {
+        return false;
+    }
+
+    if (mStart > 0)
+    {
+        memmove(mBuffer.data(), mBuffer.data() + mStart, mEnd - mStart);
+        mEnd -= mStart;
+        mStart = 0;
+    }
+
+    if (mEnd == mBuffer.size())
+    {
+        // A tag larger than the whole buffer
+        mError = true;
+        return false;
+    }
+
+    auto read = mFile.Read(mBuffer.data() + mEnd, mBuffer.size() - mEnd);
+    if (read <= 0)
+    {
+        mEof = true;
+        return false;
+    }
+
+    mEnd += (size_t)read;
+    mRead += (size_t)read;
+    return true;
+}
+
+/**
+ * Find the end of the markup that starts with the '<' at from.
+ * @param from Offset of the '<' in mBuffer
+ * @return Offset just past the closing '>', or 0 if the
+ * markup does not end in the data we have
+ */
+size_t AquaReader::FindTagEnd(size_t from)
+{
+    const char *data = mData;
+    auto remaining = mEnd - from;
+
+    if (remaining >= 4 && memcmp(data + from, "<!--", 4) == 0)
+    {
+        for (size_t i = from + 4; i + 3 <= mEnd; i++)
+        {
+            if (memcmp(data + i, "-->", 3) == 0)
+            {
+                return i + 3;
+            }
+        }
+        return 0;
+    }
+
+    // A '>' inside a quoted attribute value does not end the tag
+    char quote = 0;
+    for (size_t i = from + 1; i < mEnd; i++)
+    {
+        char c = data[i];
+        if (quote != 0)
+        {
+            if (c == quote)
+            {
+                quote = 0;
+            }
+        }
+        else if (c == '"' || c == '\'')
+        {
+            quote = c;
+        }
+        else if (c == '>')
+        {
+            return i + 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Advance to the next element start tag.
+ * @return false at the end of the file or if the file
+ * is malformed, which HasError then reports
+ */
+bool AquaReader::Next()
+{
+    while (!mError)
+    {
+        // Skip any text to the next piece of markup
+        auto lt = (const char *)memchr(mData + mStart, '<', mEnd - mStart);
+        if (lt == nullptr)
+        {
+            mStart = mEnd;
+            if (!Fill())
+            {
+                // Running out of file inside an element is an error
+                mError = mError || (mOpen > 0 && !mMemory) || !IsOpen();
+                return false;
+            }
+            continue;
+        }
+
+        mStart = lt - mData;
+        auto end = FindTagEnd(mStart);
+        if (end == 0)
+        {
+            if (!Fill())
+            {
+                mError = true;
+                return false;
+            }
+            continue;
+        }
+
+        const char *begin = mData + mStart;
+        const char *last = mData + end;
+        mStart = end;
+
+        if (begin[1] == '?' || begin[1] == '!')
+        {
+            // Declaration or comment
+            continue;
+        }
+
+        if (begin[1] == '/')
+        {
+            mOpen--;
+            if (mOpen < 0)
+            {
+                mError = true;
+                return false;
+            }
+            continue;
+        }
+
+        if (!ParseTag(begin + 1, last - 1))
+        {
+            mError = true;
+            return false;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Parse the name and attributes of a start tag
+ * @param begin First character after the '<'
+ * @param end The closing '>'
+ * @return false if the tag is malformed
+ */
+bool AquaReader::ParseTag(const char *begin, const char *end)
+{
+    bool empty = end > begin && end[-1] == '/';
+    if (empty)
+    {
+        end--;
+    }
+
+    auto p = begin;
+    while (p < end && !IsSpace(*p))
+    {
+        p++;
+    }
+
+    if (p == begin)
+    {
+        return false;
+    }
+
+    mName.assign(begin, p);
+    mAttributeCount = 0;
+
+    while (true)
+    {
+        while (p < end && IsSpace(*p))
+        {
+            p++;
+        }
+
+        if (p == end)
+        {
+            break;
+        }
+
+        auto nameBegin = p;
+        while (p < end && *p != '=' && !IsSpace(*p))
+        {
+            p++;
+        }
+        auto nameEnd = p;
+
+        while (p < end && IsSpace(*p))
+        {
+            p++;
+        }
+
+        if (p == end || *p != '=' || nameBegin == nameEnd)
+        {
+            return false;
+        }
+        p++;
+
+        while (p < end && IsSpace(*p))
+        {
+            p++;
+        }
+
+        if (p == end || (*p != '"' && *p != '\''))
+        {
+            return false;
+        }
+
+        char quote = *p++;
+        auto valueBegin = p;
+        while (p < end && *p != quote)
+        {
+            p++;
+        }
+
+        if (p == end)
+        {
+            return false;
+        }
+
+        if (mAttributeCount == mAttributes.size())
+        {
+            mAttributes.emplace_back();
+        }
+
+        auto &attribute = mAttributes[mAttributeCount++];
+        attribute.name.assign(nameBegin, nameEnd);
+        Decode(valueBegin, p, attribute.value);
+        p++;
+    }
+
+    mDepth = mOpen + 1;
+    if (!empty)
+    {
+        mOpen++;
+    }
+
+    return true;
+}
+
+/**
+ * Copy an attribute value, replacing entity references
+ * @param begin Start of the value in the file
+ * @param end End of the value in the file
+ * @param value String to put the value into
+ */
+void AquaReader::Decode(const char *begin, const char *end, std::string &value)
+{
+    auto amp = (const char *)memchr(begin, '&', end - begin);
+    if (amp == nullptr)
+    {
+        value.assign(begin, end);
+        return;
+    }
+
+    value.assign(begin, amp);
+    auto p = amp;
+    while (p < end)
+    {
+        if (*p != '&')
+        {
+            value.push_back(*p++);
+            continue;
+        }
+
+        auto semi = (const char *)memchr(p, ';', end - p);
+        if (semi == nullptr)
+        {
+            value.append(p, end);
+            return;
+        }
+
+        string_view entity(p + 1, semi - p - 1);
+        if (entity == "amp")
+        {
+            value.push_back('&');
+        }
+        else if (entity == "lt")
+        {
+            value.push_back('<');
+        }
+        else if (entity == "gt")
+        {
+            value.push_back('>');
+        }
+        else if (entity == "quot")
+        {
+            value.push_back('"');
+        }
+        else if (entity == "apos")
+        {
+            value.push_back('\'');
+        }
+        else if (entity.size() > 1 && entity[0] == '#')
+        {
+            unsigned int code = 0;
+            bool hex = entity[1] == 'x';
+            from_chars(entity.data() + (hex ? 2 : 1), entity.data() + entity.size(), code, hex ? 16 : 10);
+            value.push_back(code < 128 ? (char)code : '?');
+        }
+        else
+        {
+            value.append(p, semi + 1);
+        }
+
+        p = semi + 1;
+    }
+}
+
+/**
+ * Does the current element have an attribute?
+ * @param name Attribute name
+ * @return true if the attribute is present
+ */
+bool AquaReader::HasAttribute(std::string_view name) const
+{
+    for (size_t i = 0; i < mAttributeCount; i++)
+    {
+        if (mAttributes[i].name == name)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Get an attribute of the current element
+ * @param name Attribute name
+ * @param def Value to return if there is no such attribute
+ * @return Attribute value, valid until the next call to Next
+ */
+std::string_view AquaReader::GetAttribute(std::string_view name, std::string_view def) const
+{
+    for (size_t i = 0; i < mAttributeCount; i++)
+    {
+        if (mAttributes[i].name == name)
+        {
+            return mAttributes[i].value;
+        }
+    }
+
+    return def;
+}
+
+/**
+ * Get a numeric attribute of the current element
+ * @param name Attribute name
+ * @param def Value to return if the attribute is missing or not a number
+ * @return Attribute value
+ */
+double AquaReader::GetDouble(std::string_view name, double def) const
+{
+    double value = def;
+    NumberText::Parse(GetAttribute(name), value);
+    return value;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file AquaReader.h
+ * @author joeyv
+ *
+ * Streaming reader for .aqua XML files.
+ */
+
+#ifndef AQUARIUM_AQUAREADER_H
+#define AQUARIUM_AQUAREADER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <wx/file.h>
+
+/**
+ * Streaming reader for .aqua XML files.
+ *
+ * This is a pull parser: each call to Next reads up to the
+ * next element start tag and makes its name and attributes
+ * available until the following call. The file is read
+ * through a fixed size buffer and nothing is kept once it
+ * has been passed, so memory does not grow with the file.
+ *
+ * It understands the subset of XML .aqua files use: the
+ * XML declaration, comments, elements and attributes with
+ * the standard entities. Text content is skipped.
+ */
+class AquaReader {
+private:
+    /// One attribute of the current element
+    struct Attribute {
+        std::string name;   ///< Attribute name
+        std::string value;  ///< Value with entities replaced
+    };
+
+    /// The file we are reading
+    wxFile mFile;
+
+    /// Fixed size buffer of file data
+    std::vector<char> mBuffer;
+
+    /// The data we are parsing, mBuffer or a fragment in memory
+    const char *mData = nullptr;
+
+    /// Start of the data in mData we have not parsed yet
+    size_t mStart = 0;
+
+    /// End of the data in mData
+    size_t mEnd = 0;
+
+    /// Size of the file in bytes
+    size_t mLength = 0;
+
+    /// Number of bytes read from the file so far
+    size_t mRead = 0;
+
+    /// True when everything has been read from the file
+    bool mEof = false;
+
+    /// True if the file is not well formed
+    bool mError = false;
+
+    /// True if we are parsing a fragment in memory, not a file
+    bool mMemory = false;
+
+    /// Name of the current element
+    std::string mName;
+
+    /// Attributes of the current element. Entries past
+    /// mAttributeCount are kept so their storage is reused.
+    std::vector<Attribute> mAttributes;
+
+    /// Number of attributes of the current element
+    size_t mAttributeCount = 0;
+
+    /// Number of elements we are inside of
+    int mOpen = 0;
+
+    /// Depth of the current element, 1 for the root
+    int mDepth = 0;
+
+    bool Fill();
+    size_t FindTagEnd(size_t from);
+    bool ParseTag(const char *begin, const char *end);
+    static void Decode(const char *begin, const char *end, std::string &value);
+
+public:
+    explicit AquaReader(const wxString &filename);
+    AquaReader(const char *begin, const char *end, int open);
+
+    /// Default constructor (disabled)
+    AquaReader() = delete;
+
+    /// Copy constructor (disabled)
+    AquaReader(const AquaReader &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const AquaReader &) = delete;
+
+    bool Next();
+
+    /**
+     * Was the file opened?
+     * @return true if the file can be read
+     */
+    bool IsOpen() const { return mFile.IsOpened() || mMemory; }
+
+    /**
+     * Did reading stop because the file is not well formed?
+     * @return true if the file is malformed
+     */
+    bool HasError() const { return mError; }
+
+    /**
+     * Get the name of the current element
+     * @return Element name
+     */
+    const std::string &GetName() const { return mName; }
+
+    /**
+     * Get the depth of the current element
+     * @return 1 for the root element, 2 for its children, and so on
+     */
+    int GetDepth() const { return mDepth; }
+
+    /**
+     * Get the number of elements the reader is inside of
+     * @return 0 outside the root element, 1 inside it, and so on
+     */
+    int GetOpen() const { return mOpen; }
+
+    /**
+     * Get how much of the file has been parsed
+     * @return Fraction of the file from 0 to 1
+     */
+    double GetProgress() const { return mLength > 0 ? double(mRead - (mEnd - mStart)) / mLength : 1; }
+
+    bool HasAttribute(std::string_view name) const;
+    std::string_view GetAttribute(std::string_view name, std::string_view def = {}) const;
+    double GetDouble(std::string_view name, double def) const;
+};
+
+#endif //AQUARIUM_AQUAREADER_H
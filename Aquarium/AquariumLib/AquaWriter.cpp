@@ -0,0 +1,207 @@
+/**
+ * @file AquaWriter.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "AquaWriter.h"
+#include "NumberText.h"
+#include <cstring>
+
+using namespace std;
+
+/// Size of the write buffer in bytes
+const size_t BufferSize = 64 * 1024;
+
+/**
+ * Constructor
+ * @param filename File to create
+ */
+AquaWriter::AquaWriter(const wxString &filename) : mBuffer(BufferSize)
+{
+    if (mFile.Open(filename, wxFile::write))
+    {
+        Write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    }
+}
+
+/**
+ * Destructor, finishes the file if Close was not called
+ */
+AquaWriter::~AquaWriter()
+{
+    Close();
+}
+
+/**
+ * Add text to the output
+ * @param text Text to add
+ */
+void AquaWriter::Write(std::string_view text)
+{
+    while (!text.empty())
+    {
+        if (mUsed == mBuffer.size())
+        {
+            Flush();
+        }
+
+        auto count = min(text.size(), mBuffer.size() - mUsed);
+        memcpy(mBuffer.data() + mUsed, text.data(), count);
+        mUsed += count;
+        text.remove_prefix(count);
+    }
+}
+
+/**
+ * Add text to the output, escaping the
+ * characters that cannot appear in a value
+ * @param text Text to add
+ */
+void AquaWriter::WriteEscaped(std::string_view text)
+{
+    size_t start = 0;
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        const char *entity = nullptr;
+        switch (text[i])
+        {
+        case '&':
+            entity = "&amp;";
+            break;
+
+        case '<':
+            entity = "&lt;";
+            break;
+
+        case '>':
+            entity = "&gt;";
+            break;
+
+        case '"':
+            entity = "&quot;";
+            break;
+
+        default:
+            continue;
+        }
+
+        Write(text.substr(start, i - start));
+        Write(entity);
+        start = i + 1;
+    }
+
+    Write(text.substr(start));
+}
+
+/**
+ * Write the buffer to the file
+ */
+void AquaWriter::Flush()
+{
+    if (mUsed > 0 && mFile.IsOpened() && mFile.Write(mBuffer.data(), mUsed) != mUsed)
+    {
+        mError = true;
+    }
+
+    mUsed = 0;
+}
+
+/**
+ * Start a new element inside the current one
+ * @param name Element name
+ */
+void AquaWriter::StartElement(std::string_view name)
+{
+    if (mTagOpen)
+    {
+        Write(">");
+    }
+
+    Write("<");
+    Write(name);
+    mOpen.emplace_back(name);
+    mTagOpen = true;
+}
+
+/**
+ * Add an attribute to the element just started
+ * @param name Attribute name
+ * @param value Attribute value
+ */
+void AquaWriter::Attribute(std::string_view name, std::string_view value)
+{
+    Write(" ");
+    Write(name);
+    Write("=\"");
+    WriteEscaped(value);
+    Write("\"");
+}
+
+/**
+ * Add a numeric attribute to the element just started.
+ * The value is written with just enough digits to read back exactly.
+ * @param name Attribute name
+ * @param value Attribute value
+ */
+void AquaWriter::Attribute(std::string_view name, double value)
+{
+    char text[NumberText::BufferSize];
+
+    Write(" ");
+    Write(name);
+    Write("=\"");
+    Write(NumberText::Format(value, text));
+    Write("\"");
+}
+
+/**
+ * End the current element
+ */
+void AquaWriter::EndElement()
+{
+    if (mOpen.empty())
+    {
+        return;
+    }
+
+    if (mTagOpen)
+    {
+        Write("/>");
+        mTagOpen = false;
+    }
+    else
+    {
+        Write("</");
+        Write(mOpen.back());
+        Write(">");
+    }
+
+    mOpen.pop_back();
+}
+
+/**
+ * End any open elements and finish the file
+ * @return true if the whole file was written
+ */
+bool AquaWriter::Close()
+{
+    if (!mFile.IsOpened())
+    {
+        return false;
+    }
+
+    while (!mOpen.empty())
+    {
+        EndElement();
+    }
+
+    Write("\n");
+    Flush();
+    if (!mFile.Close())
+    {
+        mError = true;
+    }
+
+    return !mError;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file AquaWriter.h
+ * @author joeyv
+ *
+ * Streaming writer for .aqua XML files.
+ */
+
+#ifndef AQUARIUM_AQUAWRITER_H
+#define AQUARIUM_AQUAWRITER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <wx/file.h>
+
+/**
+ * Streaming writer for .aqua XML files.
+ *
+ * Elements and attributes are formatted straight into a
+ * fixed size buffer that is written to the file whenever
+ * it fills, so no document tree is built. The output is
+ * the same as wxXmlDocument writes without indentation.
+ */
+class AquaWriter {
+private:
+    /// The file we are writing
+    wxFile mFile;
+
+    /// Fixed size buffer of output not yet written to the file
+    std::vector<char> mBuffer;
+
+    /// Number of bytes used in mBuffer
+    size_t mUsed = 0;
+
+    /// True if a write to the file failed
+    bool mError = false;
+
+    /// Names of the elements we are inside of
+    std::vector<std::string> mOpen;
+
+    /// True if the start tag of the innermost element
+    /// is still open for attributes
+    bool mTagOpen = false;
+
+    void Write(std::string_view text);
+    void WriteEscaped(std::string_view text);
+    void Flush();
+
+public:
+    explicit AquaWriter(const wxString &filename);
+    virtual ~AquaWriter();
+
+    /// Default constructor (disabled)
+    AquaWriter() = delete;
+
+    /// Copy constructor (disabled)
+    AquaWriter(const AquaWriter &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const AquaWriter &) = delete;
+
+    /**
+     * Was the file created?
+     * @return true if the file can be written
+     */
+    bool IsOpen() const { return mFile.IsOpened(); }
+
+    void StartElement(std::string_view name);
+    void Attribute(std::string_view name, std::string_view value);
+    void Attribute(std::string_view name, double value);
+    void EndElement();
+    bool Close();
+};
+
+#endif //AQUARIUM_AQUAWRITER_H
@@ -4,50 +4,451 @@
  */
 #include "pch.h"
 #include "Aquarium.h"
-#include "FishBeta.h"
-#include "DecorCastle.h"
-#include "SpartyFish.h"
-#include "StinkyFish.h"
 #include "Item.h"
+#include "SpeciesRegistry.h"
+#include "ImagePreloader.h"
+#include "TankFile.h"
+#include "AquaBinaryReader.h"
+#include <algorithm>
+#include <atomic>
 
 using namespace std;
 
+/// Size of the spatial grid cells in pixels, about
+/// the size of our largest sprite
+const double GridCellSize = 256;
+
+/// Most damaged rectangles we track before we
+/// switch to marking damaged tiles
+const size_t MaxDamageRects = 64;
+
+/// Size of the square tiles damage is marked in once
+/// there is too much of it to track as rectangles
+const int DamageTileSize = 64;
+
+/// Number of tiles the damage grid extends past each edge
+/// of the aquarium, so fish partly outside it are covered
+const int DamageTileMargin = 4;
+
+/// Background image filename
+const wstring BackgroundImageName = L"images/background1.png";
+
+/// Duration of one simulation step in seconds
+const double StepTime = 1.0 / 120;
+
+/// Most simulation steps we take to catch up in one
+/// Advance. Time beyond this is dropped, so a long stall
+/// pauses the fish rather than teleporting them.
+const int MaxCatchUpSteps = 8;
+
+/// Default number of items in each chunk of a parallel
+/// Update, enough to be worth handing to another thread
+const int DefaultGrainSize = 16384;
+
+/// Number of items SetTankData creates between progress reports
+const size_t TankDataProgressInterval = 4096;
+
+/// Number of handle generations an aquarium takes at a time
+const uint32_t GenerationBlock = 4096;
+
+/**
+ * Get the rectangle an item covers when drawn at a location
+ * @param item The item
+ * @param x X location of the item center
+ * @param y Y location of the item center
+ * @return Rectangle in pixels, including a pixel of slack for rounding
+ */
+static wxRect ItemRect(const Item *item, double x, double y)
+{
+    int wid = item->GetWidth();
+    int hit = item->GetHeight();
+    return wxRect(int(x - wid / 2.0) - 1, int(y - hit / 2.0) - 1, wid + 2, hit + 2);
+}
+
 /**
  * Aquarium Constructor
  */
-Aquarium::Aquarium()
+Aquarium::Aquarium() : mGrid(GridCellSize), mStaticGrid(GridCellSize), mGrainSize(DefaultGrainSize)
 {
     // Seed the random number generator
     std::random_device rd;
     mRandom.seed(rd());
 
-    mBackground = std::make_unique<wxBitmap>(
-            L"images/background1.png", wxBITMAP_TYPE_ANY);
+    mBackground = std::make_unique<wxBitmap>(ImagePreloader::Instance().Get(BackgroundImageName));
+}
+
+/**
+ * Get every image file an aquarium and its items can display
+ * @return Image filenames, to pass to ImagePreloader::Start
+ */
+vector<wstring> Aquarium::GetImageFiles()
+{
+    vector<wstring> filenames{BackgroundImageName};
+
+    auto &registry = SpeciesRegistry::Instance();
+    for (int i = 0; i < registry.GetCount(); i++)
+    {
+        filenames.push_back(registry.GetSpecies(i).GetImage());
+    }
 
+    return filenames;
 }
 
 
 
 /**
  * Draw the aquarium
+ *
+ * The background, title and decor come from the static
+ * layer, so only the fish are drawn each frame. Decor
+ * is therefore always behind the fish.
+ *
  * @param dc The device context to draw on
  */
 void Aquarium::OnDraw(wxDC *dc)
 {
-    dc->DrawBitmap(*mBackground, 0, 0);
+    UpdateStaticLayer();
+
+    dc->DrawBitmap(*mStaticLayer, 0, 0);
+
+    for(auto item : mAnimatedItems)
+    {
+        item->Draw(dc);
+    }
+}
+
+/**
+ * Redraw the static layer if anything on it has changed
+ */
+void Aquarium::UpdateStaticLayer()
+{
+    if (mStaticLayerDirty)
+    {
+        DrawStaticLayer();
+    }
+}
+
+/**
+ * Publish a snapshot of where the animated items are
+ * now for DrawSnapshot to draw. The items are in
+ * drawing order.
+ */
+void Aquarium::Publish()
+{
+    auto &snapshot = mSnapshots.GetWriteBuffer();
+    snapshot.clear();
+    for (auto item : mAnimatedItems)
+    {
+        auto slot = item->GetSlot();
+        snapshot.push_back({item, mKinematics.DrawX(slot),
+                mKinematics.DrawY(slot), mKinematics.Mirror(slot) != 0});
+    }
+
+    mSnapshots.Publish();
+}
+
+/**
+ * Draw the parts of the aquarium inside some rectangles
+ * from the latest published snapshot.
+ *
+ * The snapshot is acquired once and walked once, however
+ * many rectangles there are, so every rectangle is drawn
+ * from the same snapshot. The rectangles are marked on a
+ * grid of tiles first, so each item is tested against the
+ * tiles it covers rather than against every rectangle. An
+ * item on a marked tile may be drawn a little outside the
+ * rectangles, so the caller should clip the device context
+ * to them.
+ *
+ * This takes no locks, so the view can paint while a
+ * SimulationThread is advancing the aquarium. Items
+ * must only be removed from the aquarium on the thread
+ * that paints, and a snapshot published before the next
+ * paint. UpdateStaticLayer must also be called on that
+ * thread after anything on the static layer changes.
+ *
+ * @param dc The device context to draw on
+ * @param rects Areas to draw in pixels
+ */
+void Aquarium::DrawSnapshot(wxDC *dc, const std::vector<wxRect> &rects)
+{
+    if (mStaticLayer == nullptr || rects.empty())
+    {
+        return;
+    }
+
+    wxMemoryDC staticDC(*mStaticLayer);
+    wxRect bounds = rects[0];
+    for (const auto &rect : rects)
+    {
+        dc->Blit(rect.x, rect.y, rect.width, rect.height, &staticDC, rect.x, rect.y);
+        bounds.Union(rect);
+    }
+
+    staticDC.SelectObject(wxNullBitmap);
+
+    int columns = (bounds.width + DamageTileSize - 1) / DamageTileSize;
+    int rows = (bounds.height + DamageTileSize - 1) / DamageTileSize;
+    mPaintTiles.assign((size_t)columns * rows, 0);
+    for (const auto &rect : rects)
+    {
+        if (rect.IsEmpty())
+        {
+            continue;
+        }
+
+        int left = (rect.GetLeft() - bounds.x) / DamageTileSize;
+        int right = (rect.GetRight() - bounds.x) / DamageTileSize;
+        int top = (rect.GetTop() - bounds.y) / DamageTileSize;
+        int bottom = (rect.GetBottom() - bounds.y) / DamageTileSize;
+        for (int row = top; row <= bottom; row++)
+        {
+            fill(&mPaintTiles[row * columns + left], &mPaintTiles[row * columns + right] + 1, 1);
+        }
+    }
+
+    for (const auto &entry : mSnapshots.Acquire())
+    {
+        auto rect = ItemRect(entry.item, entry.x, entry.y).Intersect(bounds);
+        if (rect.IsEmpty())
+        {
+            continue;
+        }
+
+        int left = (rect.GetLeft() - bounds.x) / DamageTileSize;
+        int right = (rect.GetRight() - bounds.x) / DamageTileSize;
+        int top = (rect.GetTop() - bounds.y) / DamageTileSize;
+        int bottom = (rect.GetBottom() - bounds.y) / DamageTileSize;
+
+        bool marked = false;
+        for (int row = top; row <= bottom && !marked; row++)
+        {
+            for (int column = left; column <= right && !marked; column++)
+            {
+                marked = mPaintTiles[row * columns + column] != 0;
+            }
+        }
+
+        if (marked)
+        {
+            entry.item->Draw(dc, entry.x, entry.y, entry.mirror);
+        }
+    }
+}
+
+/**
+ * Record that an area of the aquarium needs to be redrawn
+ *
+ * Up to MaxDamageRects rectangles are kept as they are. Past
+ * that, the damage is marked on a grid of tiles instead, so
+ * a lot of small changes redraw only the tiles they touch.
+ *
+ * @param rect Area in pixels
+ */
+void Aquarium::Damage(const wxRect &rect)
+{
+    lock_guard<mutex> lock(mDamageMutex);
+    if (mDamageAll)
+    {
+        return;
+    }
+
+    if (!mDamageTiled && mDamage.size() < MaxDamageRects)
+    {
+        mDamage.push_back(rect);
+        return;
+    }
+
+    StartTiles();
+    MarkTiles(rect);
+}
+
+/**
+ * Record that the whole aquarium needs to be redrawn
+ */
+void Aquarium::DamageAll()
+{
+    lock_guard<mutex> lock(mDamageMutex);
+    mDamageAll = true;
+    mDamageTiled = false;
+    mDamage.clear();
+}
+
+/**
+ * Record that the area every animated item
+ * is drawn at now needs to be redrawn
+ * @param count Number of animated items
+ */
+void Aquarium::DamageAnimated(int count)
+{
+    lock_guard<mutex> lock(mDamageMutex);
+    if (mDamageAll)
+    {
+        return;
+    }
+
+    StartTiles();
+    for (int i = 0; i < count && !mDamageAll; i++)
+    {
+        MarkTiles(ItemRect(mKinematics.Owner(i), mKinematics.DrawX(i), mKinematics.DrawY(i)));
+    }
+}
+
+/**
+ * Switch to marking damage on tiles, moving any
+ * damaged rectangles onto them.
+ * Call this with mDamageMutex held.
+ */
+void Aquarium::StartTiles()
+{
+    if (mDamageTiled)
+    {
+        return;
+    }
+
+    mDamageColumns = (GetWidth() + DamageTileSize - 1) / DamageTileSize + 2 * DamageTileMargin;
+    mDamageRows = (GetHeight() + DamageTileSize - 1) / DamageTileSize + 2 * DamageTileMargin;
+    mDamageTiles.assign(mDamageColumns * mDamageRows, 0);
+    mDamageTileCount = 0;
+    mDamageTiled = true;
+
+    for (const auto &rect : mDamage)
+    {
+        MarkTiles(rect);
+    }
+
+    mDamage.clear();
+}
+
+/**
+ * Mark the tiles an area covers as damaged. If the area
+ * reaches past the tiles or every tile ends up marked,
+ * the whole aquarium is damaged instead.
+ * Call this with mDamageMutex held.
+ * @param rect Area in pixels
+ */
+void Aquarium::MarkTiles(const wxRect &rect)
+{
+    if (rect.IsEmpty())
+    {
+        return;
+    }
+
+    const int margin = DamageTileMargin * DamageTileSize;
+    int left = (rect.GetLeft() + margin) / DamageTileSize;
+    int right = (rect.GetRight() + margin) / DamageTileSize;
+    int top = (rect.GetTop() + margin) / DamageTileSize;
+    int bottom = (rect.GetBottom() + margin) / DamageTileSize;
+    if (rect.GetLeft() < -margin || rect.GetTop() < -margin ||
+            right >= mDamageColumns || bottom >= mDamageRows)
+    {
+        mDamageAll = true;
+        mDamageTiled = false;
+        return;
+    }
+
+    for (int row = top; row <= bottom; row++)
+    {
+        auto tiles = &mDamageTiles[row * mDamageColumns];
+        for (int column = left; column <= right; column++)
+        {
+            if (!tiles[column])
+            {
+                tiles[column] = 1;
+                mDamageTileCount++;
+            }
+        }
+    }
+
+    if (mDamageTileCount == mDamageTiles.size())
+    {
+        mDamageAll = true;
+        mDamageTiled = false;
+    }
+}
+
+/**
+ * Get the areas that need to be redrawn and forget them
+ *
+ * Damaged tiles come back as one rectangle for each
+ * run of them along a row.
+ *
+ * @param rects Vector the damaged rectangles are put into
+ * @return true if the whole aquarium needs to be redrawn,
+ * in which case rects is left empty
+ */
+bool Aquarium::TakeDamage(std::vector<wxRect> &rects)
+{
+    lock_guard<mutex> lock(mDamageMutex);
+    rects.clear();
+    if (mDamageAll)
+    {
+        mDamageAll = false;
+        return true;
+    }
+
+    if (!mDamageTiled)
+    {
+        rects.swap(mDamage);
+        return false;
+    }
+
+    for (int row = 0; row < mDamageRows; row++)
+    {
+        auto tiles = &mDamageTiles[row * mDamageColumns];
+        for (int column = 0; column < mDamageColumns; column++)
+        {
+            if (!tiles[column])
+            {
+                continue;
+            }
+
+            int start = column;
+            while (column < mDamageColumns && tiles[column])
+            {
+                column++;
+            }
+
+            rects.emplace_back((start - DamageTileMargin) * DamageTileSize,
+                    (row - DamageTileMargin) * DamageTileSize,
+                    (column - start) * DamageTileSize, DamageTileSize);
+        }
+    }
+
+    mDamageTiled = false;
+    return false;
+}
+
+/**
+ * Draw the parts of the aquarium that do not animate
+ * into the static layer bitmap.
+ */
+void Aquarium::DrawStaticLayer()
+{
+    if (mStaticLayer == nullptr)
+    {
+        mStaticLayer = std::make_unique<wxBitmap>(
+                mBackground->GetWidth(), mBackground->GetHeight());
+    }
+
+    wxMemoryDC dc(*mStaticLayer);
+    dc.DrawBitmap(*mBackground, 0, 0);
 
     wxFont font(wxSize(0, 20),
             wxFONTFAMILY_SWISS,
             wxFONTSTYLE_NORMAL,
             wxFONTWEIGHT_NORMAL);
-    dc->SetFont(font);
-    dc->SetTextForeground(wxColour(0, 64, 0));
-    dc->DrawText(L"Under the Sea!", 10, 10);
+    dc.SetFont(font);
+    dc.SetTextForeground(wxColour(0, 64, 0));
+    dc.DrawText(L"Under the Sea!", 10, 10);
 
-    for(auto item : mItems)
+    for(auto item : mStaticItems)
     {
-        item->Draw(dc);
+        item->Draw(&dc);
     }
+
+    dc.SelectObject(wxNullBitmap);
+    mStaticLayerDirty = false;
 }
 
 /// Initial fish X location
@@ -56,198 +457,821 @@ const int InitialX = 200;
 /// Initial fish Y location
 const int InitialY = 200;
 
+/// Distance we step along the diagonal looking for a free location
+const int PlacementStep = 10;
+
 /** Add an item to the aquarium
+ *
+ * The item is placed at the first free location along a
+ * diagonal starting at InitialX, InitialY.
+ *
  * @param item New item to add
  */
-void Aquarium::Add(std::shared_ptr<Item> item)
+void Aquarium::Add(Item *item)
+{
+    double x = InitialX;
+    double y = InitialY;
+    FindFreeLocation(x, y);
+
+    item->SetLocation(x, y);
+    Insert(item);
+}
+
+/**
+ * Find a location no other item is centered at.
+ *
+ * Steps diagonally from x, y until there is no item within
+ * a pixel of the location.
+ *
+ * @param x X location to start at, set to the free location
+ * @param y Y location to start at, set to the free location
+ */
+void Aquarium::FindFreeLocation(double &x, double &y)
 {
-    int x = 10;
-    int y = 10;
+    SyncGrid();
+    while (mGrid.AnyWithin(x, y, 1) || mStaticGrid.AnyWithin(x, y, 1))
+    {
+        x += PlacementStep;
+        y += PlacementStep;
+    }
+}
 
-    if (mItems.empty())
+/**
+ * Get the pool items of a type are allocated from
+ * @param type Index of the item type, from ItemPool::TypeId
+ * @param size Size of an item of the type in bytes
+ * @param destroy Function that destroys an item of the type,
+ * or null if items of the type are freed without destroying them
+ * @return The pool, created if this is the first item of the type
+ */
+ItemPool &Aquarium::GetPool(int type, size_t size, void (*destroy)(void *item))
+{
+    if (type >= (int)mPools.size())
     {
-        item->SetLocation(InitialX, InitialY);
-        mItems.push_back(item);
+        mPools.resize(type + 1);
     }
 
-    else {
-        item->SetLocation(InitialX, InitialY);
-        for (auto k : mItems) {
+    auto &pool = mPools[type];
+    if (pool == nullptr)
+    {
+        pool = make_unique<ItemPool>(size, destroy);
+    }
 
-            if(item->DistanceTo(k) < 1)
-            {
-                item->SetLocation(InitialX + x, InitialY + y);
-                x += 10;
-                y += 10;
-
-                for(auto j:mItems)
-                {
-                    if(item->DistanceTo(j) < 1)
-                    {
-                        item->SetLocation(InitialX + x, InitialY + y);
-                        x += 10;
-                        y += 10;
-                    }
-                }
-            }
+    return *pool;
+}
+
+/**
+ * Take ownership of a new item, giving it a handle
+ * @param item Item just constructed in one of our pools
+ */
+void Aquarium::Own(Item *item)
+{
+    // Generations are unique across every aquarium, so a
+    // handle never matches an item created after it was
+    // taken, even after the items are swapped or cleared.
+    // They are taken in blocks, so most items need no
+    // atomic operation.
+    static atomic<uint32_t> generations {0};
+    uint32_t generation;
+    do
+    {
+        if (mNextGeneration == mGenerationEnd)
+        {
+            mNextGeneration = generations.fetch_add(GenerationBlock);
+            mGenerationEnd = mNextGeneration + GenerationBlock;
+        }
+
+        generation = mNextGeneration++;
+    } while (generation == 0);
+
+    item->mHandle.index = (uint32_t)mHandles.size();
+    item->mHandle.generation = generation;
+    mHandles.push_back(item);
+}
+
+/**
+ * Get the item a handle refers to
+ * @param handle Handle from Item::GetHandle
+ * @return The item, or null if it is no longer in this aquarium
+ */
+Item *Aquarium::Get(ItemHandle handle) const
+{
+    if (handle.index < mHandles.size())
+    {
+        auto item = mHandles[handle.index];
+        if (item->mHandle.generation == handle.generation)
+        {
+            return item;
         }
-        mItems.push_back(item);
     }
+
+    return nullptr;
 }
 
 /**
- * Test an x,y click location to see if it clicked
- * on some item in the aquarium.
- * @param x X location in pixels
- * @param y Y location in pixels
- * @returns Pointer to item we clicked on or nullptr if none.
-*/
-std::shared_ptr<Item> Aquarium::HitTest(int x, int y)
+ * Keep a sprite loaded for as long as this aquarium owns
+ * items, which refer to it with a plain pointer
+ * @param sprite Sprite an item of this aquarium displays
+ * @return Pointer to the sprite
+ */
+Sprite *Aquarium::Retain(const std::shared_ptr<Sprite> &sprite)
 {
-    for (auto i = mItems.rbegin(); i != mItems.rend();  i++)
+    // There are only a handful of sprites
+    for (auto &retained : mSprites)
     {
-        if ((*i)->HitTest(x, y))
+        if (retained == sprite)
         {
-            return *i;
+            return retained.get();
         }
     }
 
-    return  nullptr;
+    mSprites.push_back(sprite);
+    return sprite.get();
 }
 
 /**
- * Sends an item to the front of a vector
- * @param item
+ * Keep the sprite of a species loaded for as long as this
+ * aquarium owns items. After the first item of the species
+ * this is an array lookup, with no lock or reference count.
+ * @param species Species of an item of this aquarium
+ * @return Pointer to the sprite
  */
-void Aquarium::SendToFront(shared_ptr<Item> item)
+Sprite *Aquarium::Retain(const Species &species)
 {
-    auto loc = find(begin(mItems), end(mItems), item);
-    if(loc != end(mItems))
+    auto index = species.GetIndex();
+    if (index >= (int)mSpeciesSprites.size())
     {
-        mItems.erase(loc);
+        mSpeciesSprites.resize(index + 1);
     }
-    mItems.push_back(item);
+
+    auto &sprite = mSpeciesSprites[index];
+    if (sprite == nullptr)
+    {
+        sprite = Retain(species.GetSprite());
+    }
+
+    return sprite;
 }
 
 /**
- * Save the aquarium as a .aqua XML file.
+ * Get the draw order an item in the aquarium belongs in
+ * @param item An item in the aquarium
+ * @return The animated or static draw order
+ */
+DrawOrder &Aquarium::GetOrder(const Item *item)
+{
+    return mKinematics.IsAnimated(item->GetSlot()) ? mAnimatedItems : mStaticItems;
+}
+
+/**
+ * Get the spatial grid an item in the aquarium belongs in
+ * @param item An item in the aquarium
+ * @return The animated or static grid
+ */
+SpatialGrid &Aquarium::GetGrid(const Item *item)
+{
+    return mKinematics.IsAnimated(item->GetSlot()) ? mGrid : mStaticGrid;
+}
+
+/**
+ * Put an item in front of all others of its partition
+ * without moving it
  *
- * Open an XML file and stream the aquarium data to it.
+ * This is the only place an item is asked whether it is
+ * animated. After that its partition follows from its
+ * Kinematics slot.
  *
- * @param filename The filename of the file to save the aquarium to
+ * @param item Item to insert
+ */
+void Aquarium::Insert(Item *item)
+{
+    bool animated = item->IsAnimated();
+    mKinematics.Activate(item->GetSlot(), animated);
+    GetOrder(item).PushFront(item);
+    mKinematics.PlaceInGrid(item->GetSlot(), GetGrid(item));
+    Damage(ItemRect(item, item->GetX(), item->GetY()));
+
+    if (!animated)
+    {
+        mStaticLayerDirty = true;
+    }
+}
+
+/**
+ * Indicate that an item has changed location
+ * @param item The item that moved
+ * @param oldX X location before the move
+ * @param oldY Y location before the move
  */
-void Aquarium::Save(const wxString &filename)
+void Aquarium::OnItemMoved(Item *item, double oldX, double oldY)
 {
-    wxXmlDocument xmlDoc;
+    // An item not yet added is in no grid and not drawn
+    if (!mKinematics.IsActive(item->GetSlot()))
+    {
+        return;
+    }
+
+    mKinematics.MoveInGrid(item->GetSlot(), GetGrid(item));
 
-    auto root = new wxXmlNode(wxXML_ELEMENT_NODE, L"aqua");
-    xmlDoc.SetRoot(root);
+    auto rect = ItemRect(item, oldX, oldY);
+    Damage(rect.Union(ItemRect(item, item->GetX(), item->GetY())));
 
-    // Iterate over all items and save them
-    for (auto item : mItems)
+    if (!mKinematics.IsAnimated(item->GetSlot()))
     {
-        item->XmlSave(root);
+        mStaticLayerDirty = true;
     }
+}
 
-    if(!xmlDoc.Save(filename, wxXML_NO_INDENTATION))
+/**
+ * Indicate that the appearance of an item has changed
+ * @param item The item that changed
+ */
+void Aquarium::OnItemChanged(Item *item)
+{
+    auto slot = item->GetSlot();
+    if (!mKinematics.IsActive(slot))
     {
-        wxMessageBox(L"Write to XML failed");
         return;
     }
+
+    Damage(ItemRect(item, mKinematics.DrawX(slot), mKinematics.DrawY(slot)));
+
+    if (!mKinematics.IsAnimated(slot))
+    {
+        mStaticLayerDirty = true;
+    }
 }
 
 /**
- * Load the aquarium from a .aqua XML file.
+ * Test an x,y click location to see if it clicked
+ * on some item in the aquarium.
  *
- * Opens the XML file and reads the nodes, creating items as appropriate.
+ * Static items are drawn behind all the animated ones,
+ * so they are only looked for if no animated item is hit.
  *
- * @param filename The filename of the file to load the aquarium from.
+ * @param x X location in pixels
+ * @param y Y location in pixels
+ * @returns Pointer to item we clicked on or nullptr if none.
+*/
+Item *Aquarium::HitTest(int x, int y)
+{
+    SyncGrid();
+    for (auto grid : {&mGrid, &mStaticGrid})
+    {
+        mQuery.clear();
+        grid->QueryPoint(x, y, mQuery);
+
+        // Of the items whose box contains the point, find
+        // the front most one that is opaque there
+        Item *front = nullptr;
+        for (auto item : mQuery)
+        {
+            if ((front == nullptr || item->GetZOrder() > front->GetZOrder()) &&
+                    item->HitTest(x, y))
+            {
+                front = item;
+            }
+        }
+
+        if (front != nullptr)
+        {
+            return front;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * Find the items centered within some distance of a point
+ * @param x X location in pixels
+ * @param y Y location in pixels
+ * @param radius Distance in pixels
+ * @return The items found, in no particular order
  */
-void Aquarium::Load(const wxString &filename)
+std::vector<Item*> Aquarium::ItemsNear(double x, double y, double radius)
 {
-    wxXmlDocument xmlDoc;
-    if(!xmlDoc.Load(filename))
+    SyncGrid();
+    std::vector<Item*> items;
+    mGrid.QueryRadius(x, y, radius, items);
+    mStaticGrid.QueryRadius(x, y, radius, items);
+    return items;
+}
+
+/**
+ * Sends an item in front of all the others of its partition.
+ * An item not in the aquarium is added.
+ * @param item Item to move
+ */
+void Aquarium::SendToFront(Item *item)
+{
+    if (!mKinematics.IsActive(item->GetSlot()))
     {
-        wxMessageBox(L"Unable to load Aquarium file");
+        Insert(item);
         return;
     }
 
-    Clear();
+    if (GetOrder(item).SendToFront(item))
+    {
+        OnItemChanged(item);
+    }
+}
 
-    // Get the XML document root node
-    auto root = xmlDoc.GetRoot();
+/**
+ * Sends an item behind all the others of its partition
+ * @param item Item to move
+ */
+void Aquarium::SendToBack(Item *item)
+{
+    if (mKinematics.IsActive(item->GetSlot()) && GetOrder(item).SendToBack(item))
+    {
+        OnItemChanged(item);
+    }
+}
+
+/**
+ * Moves an item in front of the item of its
+ * partition just in front of it
+ * @param item Item to move
+ */
+void Aquarium::Raise(Item *item)
+{
+    if (mKinematics.IsActive(item->GetSlot()) && GetOrder(item).Raise(item))
+    {
+        OnItemChanged(item);
+    }
+}
 
-    //
-    // Traverse the children of the root
-    // node of the XML document in memory!!!!
-    //
-    auto child = root->GetChildren();
-    for( ; child; child=child->GetNext())
+/**
+ * Moves an item behind the item of its
+ * partition just behind it
+ * @param item Item to move
+ */
+void Aquarium::Lower(Item *item)
+{
+    if (mKinematics.IsActive(item->GetSlot()) && GetOrder(item).Lower(item))
     {
-        auto name = child->GetName();
-        if(name == L"item")
+        OnItemChanged(item);
+    }
+}
+
+/**
+ * Save the aquarium as a .aqua XML file.
+ * @param filename The filename of the file to save the aquarium to
+ * @return false if the file could not be written
+ */
+bool Aquarium::Save(const wxString &filename)
+{
+    TankData data;
+    GetTankData(data);
+    return TankFile::Write(filename, data, TankFile::Format::Xml);
+}
+
+/**
+ * Save the aquarium as a binary tank file.
+ * @param filename The filename of the file to save the aquarium to
+ * @return false if the file could not be written
+ */
+bool Aquarium::SaveBinary(const wxString &filename)
+{
+    TankData data;
+    GetTankData(data);
+    return TankFile::Write(filename, data, TankFile::Format::Binary);
+}
+
+/**
+ * Load the aquarium from a .aqua XML or binary tank file.
+ *
+ * If the file cannot be read the aquarium is left as it was.
+ *
+ * @param filename The filename of the file to load the aquarium from.
+ * @return false if the file could not be read
+ */
+bool Aquarium::Load(const wxString &filename)
+{
+    {
+        AquaBinaryReader binary(filename);
+        if (binary.IsBinary())
         {
-            XmlItem(child);
+            return SetTankData(binary);
         }
+    }
 
+    TankData data;
+    if (!TankFile::Read(filename, data))
+    {
+        return false;
     }
+
+    SetTankData(data);
+    return true;
 }
 
 /**
  * Clear the aquarium data.
  *
- * Deletes all known items in the aquarium.
+ * Frees every item the aquarium owns, whether or not it was
+ * added. Items of IsPoolReleasable types are freed in time
+ * that depends on the number of pool slabs rather than the
+ * number of items; other items are destroyed one by one.
+ * Handles to the items no longer refer to anything.
  */
 void Aquarium::Clear()
 {
-    mItems.clear();
+    mAnimatedItems.Clear();
+    mStaticItems.Clear();
+    mHandles.clear();
+    for (auto &pool : mPools)
+    {
+        if (pool != nullptr)
+        {
+            pool->Release();
+        }
+    }
+
+    mSprites.clear();
+    mSpeciesSprites.clear();
+    mKinematics.Clear();
+    mGrid.Clear();
+    mGridDirty = false;
+    mStaticGrid.Clear();
+    mStaticLayerDirty = true;
+    DamageAll();
 }
 
 /**
- * Handle a node of type item.
- * @param node XML node
+ * Get the items of the aquarium as plain data that
+ * can be written to a file on another thread
+ *
+ * The static items come first, as they are drawn behind
+ * the animated ones.
+ *
+ * @param data Data to fill with the items, back to front
  */
-void Aquarium::XmlItem(wxXmlNode *node)
+void Aquarium::GetTankData(TankData &data)
 {
-    // A pointer for the item we are loading
-    shared_ptr<Item> item;
+    data.species.clear();
+    data.items.clear();
+    data.items.reserve(mStaticItems.GetCount() + mAnimatedItems.GetCount());
 
-    // We have an item. What type?
-    auto type = node->GetAttribute(L"type");
-    if (type == L"beta")
+    // Species of each entry in data.species. Species are
+    // interned by the registry, so comparing pointers is
+    // enough, and there are only a handful of them, so a
+    // linear search of the table is fastest.
+    vector<const Species *> table;
+
+    for (auto order : {&mStaticItems, &mAnimatedItems})
     {
-        item = make_shared<FishBeta>(this);
+        for (auto item : *order)
+        {
+            auto itemSpecies = item->GetSpecies();
+
+            size_t species = 0;
+            while (species < table.size() && table[species] != itemSpecies)
+            {
+                species++;
+            }
+
+            if (species == table.size())
+            {
+                table.push_back(itemSpecies);
+                data.species.push_back(TankSpecies{string(item->GetType()), item->IsAnimated()});
+            }
+
+            auto slot = item->GetSlot();
+
+            AquaBinaryRecord record;
+            record.x = mKinematics.X(slot);
+            record.y = mKinematics.Y(slot);
+            record.speedX = mKinematics.SpeedX(slot);
+            record.speedY = mKinematics.SpeedY(slot);
+            record.species = (uint32_t)species;
+            data.items.push_back(record);
+        }
     }
-    else if(type == L"castle")
+}
+
+/**
+ * Replace the items of the aquarium with ones built from records.
+ *
+ * Each record is copied straight into the Kinematics slot of
+ * a new item of its species. The items are created and added
+ * in one pass, filling the pool slabs and the Kinematics arrays
+ * in order. There is no search for a free location and no damage
+ * for each item, as the whole aquarium is redrawn. The slots
+ * are activated all at once at the end.
+ *
+ * @tparam Records Called as records(index) to get each record,
+ * which must already be known to be usable
+ * @param table Species of each species index, null if not registered
+ * @param count Number of records, back to front
+ * @param records Gets the records
+ * @param progress Function told of progress, may be null
+ * @return false if progress cancelled the build, in which
+ * case the aquarium is left empty
+ */
+template <class Records>
+bool Aquarium::BuildItems(const vector<const Species *> &table, size_t count, Records records,
+        const std::function<bool(double progress)> &progress)
+{
+    Clear();
+
+    mKinematics.Reserve((int)count);
+    mHandles.reserve(count);
+
+    for (size_t i = 0; i < count; i++)
     {
-        item = make_shared<DecorCastle>(this);
+        if (i % TankDataProgressInterval == 0 && progress != nullptr && !progress(double(i) / count))
+        {
+            Clear();
+            return false;
+        }
+
+        auto record = records(i);
+        auto species = table[record.species];
+        if (species != nullptr)
+        {
+            auto item = species->Create(this);
+            auto slot = item->GetSlot();
+            mKinematics.X(slot) = record.x;
+            mKinematics.Y(slot) = record.y;
+            mKinematics.SpeedX(slot) = record.speedX;
+            mKinematics.SpeedY(slot) = record.speedY;
+
+            auto animated = item->IsAnimated();
+            (animated ? mAnimatedItems : mStaticItems).PushFront(item);
+            mKinematics.PlaceInGrid(slot, animated ? mGrid : mStaticGrid);
+        }
     }
-    else if(type == L"sparty")
+
+    // The grid locations move with the slots
+    mKinematics.ActivateAll();
+
+    return true;
+}
+
+/**
+ * Replace the items of the aquarium with ones from plain data.
+ *
+ * The species table is looked up in the SpeciesRegistry once,
+ * so creating each item does not depend on its type tag.
+ * Items of unknown species are skipped.
+ *
+ * Nothing here needs the main thread as long as the sprites
+ * of the species in the data are already loaded, so a large
+ * tank can be built in an aquarium of its own on another
+ * thread, then swapped in with SwapItems.
+ *
+ * @param data Items to create, back to front
+ * @param progress Function told of progress, may be null. If it
+ * returns false the aquarium is left with none of the items.
+ * @return false if progress cancelled the build
+ */
+bool Aquarium::SetTankData(const TankData &data, const std::function<bool(double progress)> &progress)
+{
+    auto &registry = SpeciesRegistry::Instance();
+    vector<const Species *> table;
+    table.reserve(data.species.size());
+    for (auto &species : data.species)
     {
-        item = make_shared<SpartyFish>(this);
+        table.push_back(registry.Find(species.type));
     }
-    else if(type == L"stinky")
+
+    return BuildItems(table, data.items.size(), [&data](size_t i) -> const AquaBinaryRecord & {
+        return data.items[i];
+    }, progress);
+}
+
+/**
+ * Replace the items of the aquarium with the ones in a binary tank file.
+ *
+ * Each record is decoded from the file mapping straight into the
+ * Kinematics slot of its item, with no TankData in between. Every
+ * record is checked in a pass over the mapping before anything is
+ * cleared, so if one has an unknown species index or an unusable
+ * location or speed, the aquarium is left as it was. Items of
+ * species that are not registered are skipped, as in
+ * SetTankData(const TankData &).
+ *
+ * @param reader Reader for the file
+ * @param progress Function told of progress, may be null. If it
+ * returns false the aquarium is left with none of the items.
+ * @return false if the file is damaged, has an unusable record,
+ * or progress cancelled the build
+ */
+bool Aquarium::SetTankData(const AquaBinaryReader &reader, const std::function<bool(double progress)> &progress)
+{
+    if (reader.HasError())
     {
-        item = make_shared<StinkyFish>(this);
+        return false;
     }
 
+    auto &registry = SpeciesRegistry::Instance();
+    vector<const Species *> table;
+    table.reserve(reader.GetSpeciesCount());
+    for (size_t i = 0; i < reader.GetSpeciesCount(); i++)
+    {
+        table.push_back(registry.Find(reader.GetSpecies(i)));
+    }
 
-    if (item != nullptr)
+    auto count = reader.GetCount();
+    for (size_t i = 0; i < count; i++)
     {
+        auto record = reader.GetRecord(i);
+        if (record.species >= table.size() || !TankFile::IsValidRecord(record))
+        {
+            return false;
+        }
+    }
+
+    return BuildItems(table, count, [&reader](size_t i) {
+        return reader.GetRecord(i);
+    }, progress);
+}
 
-        Add(item);
-        item->XmlLoad(node);
+/**
+ * Exchange the items of this aquarium with those of another.
+ *
+ * This lets a large tank be built in an aquarium nobody
+ * is drawing, then swapped into the one on the screen in
+ * time that does not depend on the number of items, other
+ * than telling each item which aquarium it is now in.
+ * Hold the mutex of both aquariums while calling this.
+ *
+ * @param other Aquarium to exchange items with
+ */
+void Aquarium::SwapItems(Aquarium &other)
+{
+    auto kernel = mKinematics.GetKernel();
+    auto otherKernel = other.mKinematics.GetKernel();
+
+    swap(mKinematics, other.mKinematics);
+    mAnimatedItems.Exchange(other.mAnimatedItems);
+    mStaticItems.Exchange(other.mStaticItems);
+    swap(mPools, other.mPools);
+    swap(mHandles, other.mHandles);
+    swap(mSprites, other.mSprites);
+    swap(mSpeciesSprites, other.mSpeciesSprites);
+    swap(mGrid, other.mGrid);
+    swap(mGridDirty, other.mGridDirty);
+    swap(mStaticGrid, other.mStaticGrid);
+
+    mKinematics.Rebind(this);
+    mKinematics.SetKernel(kernel);
+    other.mKinematics.Rebind(&other);
+    other.mKinematics.SetKernel(otherKernel);
+
+    for (auto aquarium : {this, &other})
+    {
+        aquarium->mAccumulator = 0;
+        aquarium->mKinematics.SetAlpha(1);
+        aquarium->mStaticLayerDirty = true;
+        aquarium->DamageAll();
     }
 }
 
 /**
  * Handle updates for animation
+ *
+ * Advances the simulation by one step of the given
+ * length and draws the items where they end up.
+ *
  * @param elapsed The time since the last update
  */
 void Aquarium::Update(double elapsed)
 {
-    for (auto item : mItems)
+    Simulate(1, elapsed, 1);
+}
+
+/**
+ * Advance the animation by the time since the last frame
+ *
+ * The simulation runs in fixed steps of StepTime no matter
+ * how often this is called. Time left over is carried to
+ * the next call, and items are drawn part way between their
+ * last two locations by that fraction of a step, so motion
+ * stays smooth without depending on the frame rate.
+ *
+ * @param elapsed The time since the last frame in seconds
+ */
+void Aquarium::Advance(double elapsed)
+{
+    mAccumulator += elapsed;
+
+    int steps = int(mAccumulator / StepTime);
+    if (steps > MaxCatchUpSteps)
+    {
+        steps = MaxCatchUpSteps;
+        mAccumulator = steps * StepTime;
+    }
+
+    mAccumulator -= steps * StepTime;
+    Simulate(steps, StepTime, mAccumulator / StepTime);
+}
+
+/**
+ * Set the number of threads Update runs on.
+ *
+ * Every item is advanced on its own, so the result is
+ * the same for any number of threads.
+ *
+ * @param threads Thread count, 1 to run Update serially
+ */
+void Aquarium::SetUpdateThreads(int threads)
+{
+    if (threads <= 1)
+    {
+        mPool = nullptr;
+    }
+    else if (threads != GetUpdateThreads())
+    {
+        mPool = make_unique<ThreadPool>(threads);
+    }
+}
+
+/**
+ * Run simulation steps and record the areas that need to be redrawn
+ *
+ * Every animated item in the aquarium is advanced in one pass
+ * over the Kinematics arrays for each step, split into chunks
+ * over the update threads if there are more than one. Static
+ * items are not looked at, so they cost nothing per frame. The
+ * spatial grid is brought up to date the next time it is used.
+ *
+ * With more than MaxDamageRects animated items, the tiles
+ * they were and are now drawn on are damaged rather than
+ * a rectangle for each of them.
+ *
+ * @param steps Number of steps to take
+ * @param elapsed Duration of each step in seconds
+ * @param alpha Fraction of the last step to draw the items at
+ */
+void Aquarium::Simulate(int steps, double elapsed, double alpha)
+{
+    auto count = mKinematics.GetAnimatedCount();
+    bool track = count <= (int)MaxDamageRects;
+
+    if (track)
+    {
+        mDrawnRects.clear();
+        mDrawnMirrors.clear();
+        for (int i = 0; i < count; i++)
+        {
+            mDrawnRects.push_back(ItemRect(mKinematics.Owner(i),
+                    mKinematics.DrawX(i), mKinematics.DrawY(i)));
+            mDrawnMirrors.push_back(mKinematics.Mirror(i));
+        }
+    }
+    else
     {
-        item->Update(elapsed);
+        DamageAnimated(count);
     }
-}
\ No newline at end of file
+
+    double width = GetWidth();
+    double height = GetHeight();
+    for (int step = 0; step < steps; step++)
+    {
+        if (mPool != nullptr)
+        {
+            mPool->ParallelFor(0, count, mGrainSize, [&](int begin, int end) {
+                mKinematics.Integrate(begin, end, elapsed, width, height);
+            });
+        }
+        else
+        {
+            mKinematics.Integrate(elapsed, width, height);
+        }
+
+        mGridDirty = true;
+    }
+
+    mKinematics.SetAlpha(alpha);
+
+    if (!track)
+    {
+        DamageAnimated(count);
+        return;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        auto rect = ItemRect(mKinematics.Owner(i), mKinematics.DrawX(i), mKinematics.DrawY(i));
+        if (rect != mDrawnRects[i] || mKinematics.Mirror(i) != mDrawnMirrors[i])
+        {
+            Damage(rect.Union(mDrawnRects[i]));
+        }
+    }
+}
+
+/**
+ * Tell the spatial grid about every animated item
+ * that has moved since it was last brought up to date
+ */
+void Aquarium::SyncGrid()
+{
+    if (mGridDirty)
+    {
+        mKinematics.SyncGrid(mGrid);
+        mGridDirty = false;
+    }
+}
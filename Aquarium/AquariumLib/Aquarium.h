@@ -8,45 +8,272 @@
 #ifndef AQUARIUM_AQUARIUM_H
 #define AQUARIUM_AQUARIUM_H
 
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <new>
 #include <random>
 
 #include "Item.h"
+#include "ItemPool.h"
+#include "SpatialGrid.h"
+#include "SnapshotBuffer.h"
+#include "ThreadPool.h"
+#include "DrawOrder.h"
 
 class Item;
+class Species;
+class AquaBinaryReader;
+struct TankData;
+struct AquaBinaryRecord;
 
 class Aquarium  {
 private:
     std::unique_ptr<wxBitmap> mBackground;  ///< Background image to use
 
-    /// All of the items to populate our aquarium
-    std::vector<std::shared_ptr<Item>> mItems;
+    /// Background, title and decor drawn once and reused every frame
+    std::unique_ptr<wxBitmap> mStaticLayer;
 
-    void XmlItem(wxXmlNode *node);
+    /// True if mStaticLayer needs to be redrawn
+    bool mStaticLayerDirty = true;
+
+    void DrawStaticLayer();
+
+    /// Guards the damage, which the simulation
+    /// thread adds to while the view takes it
+    std::mutex mDamageMutex;
+
+    /// Areas that need to be redrawn since the last TakeDamage
+    std::vector<wxRect> mDamage;
+
+    /// True if the whole aquarium needs to be redrawn
+    bool mDamageAll = true;
+
+    /// True if damage is being marked on mDamageTiles
+    /// because there was too much to keep as rectangles
+    bool mDamageTiled = false;
+
+    /// One entry for each tile, row by row, set if
+    /// anything in the tile needs to be redrawn
+    std::vector<char> mDamageTiles;
+
+    /// Number of entries in mDamageTiles that are set
+    size_t mDamageTileCount = 0;
+
+    /// Number of columns of damage tiles
+    int mDamageColumns = 0;
+
+    /// Number of rows of damage tiles
+    int mDamageRows = 0;
+
+    void Damage(const wxRect &rect);
+    void DamageAll();
+    void DamageAnimated(int count);
+    void StartTiles();
+    void MarkTiles(const wxRect &rect);
+
+    /// Location and motion of the items
+    Kinematics mKinematics;
+
+    /// The animated items in the aquarium, in drawing order
+    DrawOrder mAnimatedItems;
+
+    /// The static items in the aquarium, in drawing order.
+    /// These are all drawn behind the animated items.
+    DrawOrder mStaticItems;
+
+    DrawOrder &GetOrder(const Item *item);
+
+    /// Memory for the items this aquarium owns, one pool
+    /// for each item type, indexed by ItemPool::TypeId
+    std::vector<std::unique_ptr<ItemPool>> mPools;
+
+    /// Every item this aquarium owns, indexed by ItemHandle::index
+    std::vector<Item*> mHandles;
+
+    /// Next handle generation to give an item
+    uint32_t mNextGeneration = 0;
+
+    /// End of the block of generations taken for this aquarium
+    uint32_t mGenerationEnd = 0;
+
+    /// The sprites of the items this aquarium owns
+    std::vector<std::shared_ptr<Sprite>> mSprites;
+
+    /// The retained sprite of each species an item has been
+    /// created for, indexed by Species::GetIndex
+    std::vector<Sprite*> mSpeciesSprites;
+
+    ItemPool &GetPool(int type, size_t size, void (*destroy)(void *item));
+    void Own(Item *item);
+
+    /// Index of the animated items by location
+    SpatialGrid mGrid;
+
+    /// True if items have moved without the grid being told
+    bool mGridDirty = false;
+
+    /// Index of the static items by location, which only
+    /// changes when one is added or dragged
+    SpatialGrid mStaticGrid;
+
+    SpatialGrid &GetGrid(const Item *item);
+
+    /// Simulation time not yet taken as a step, in seconds
+    double mAccumulator = 0;
+
+    /// Where each active item was drawn before a simulation
+    /// step, used to find the area that needs to be redrawn
+    std::vector<wxRect> mDrawnRects;
+
+    /// Mirror flag of each active item before a simulation step,
+    /// since a fish can turn without its rectangle changing
+    std::vector<uint8_t> mDrawnMirrors;
+
+    /// Threads that run Update in parallel, or null to run it serially
+    std::unique_ptr<ThreadPool> mPool;
+
+    /// Number of items in each chunk of a parallel Update
+    int mGrainSize;
+
+    void Simulate(int steps, double elapsed, double alpha);
+
+    void SyncGrid();
+
+    /// Scratch space for grid queries
+    std::vector<Item*> mQuery;
+
+    void Insert(Item *item);
+
+    template <class Records>
+    bool BuildItems(const std::vector<const Species *> &table, size_t count, Records records,
+            const std::function<bool(double progress)> &progress);
 
     /// Random number generator
     std::mt19937 mRandom;
 
+    /// Held by whoever is using the aquarium while a
+    /// SimulationThread is running
+    std::mutex mMutex;
+
+    /// Snapshots of the animated items for drawing
+    SnapshotBuffer mSnapshots;
+
+    /// Tiles the rectangles being drawn by DrawSnapshot cover,
+    /// only used on the thread that paints
+    std::vector<char> mPaintTiles;
+
 
 public:
     Aquarium();
 
+    static std::vector<std::wstring> GetImageFiles();
+
     /**
      * Get the random number generator
      * @return Pointer to the random number generator
      */
     std::mt19937 &GetRandom() {return mRandom;}
 
+    /**
+     * Get the arrays that store item location and motion
+     * @return Reference to the Kinematics object
+     */
+    Kinematics &GetKinematics() { return mKinematics; }
+
     void OnDraw(wxDC* dc);
-    void Add(std::shared_ptr<Item> item);
+    bool TakeDamage(std::vector<wxRect> &rects);
+
+    void UpdateStaticLayer();
 
-    std::shared_ptr<Item> HitTest(int x, int y);
+    /**
+     * Does the static layer need to be redrawn?
+     * @return true if something on the static layer has changed
+     * since it was last drawn
+     */
+    bool IsStaticLayerDirty() const { return mStaticLayerDirty; }
+    void Publish();
+    void DrawSnapshot(wxDC* dc, const std::vector<wxRect> &rects);
+
+    /**
+     * Get the mutex that guards the aquarium while
+     * a SimulationThread is running
+     * @return The aquarium mutex
+     */
+    std::mutex &GetMutex() { return mMutex; }
+
+    /**
+     * Create an item owned by this aquarium. The item is
+     * not in the aquarium until it is passed to Add.
+     * @tparam T Item type, constructed from a pointer to this aquarium
+     * @return The new item, which lives until the aquarium is cleared
+     * and is destroyed then unless IsPoolReleasable<T> is true
+     */
+    template <class T>
+    T *Create()
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Items must not need extra alignment");
+        auto destroy = IsPoolReleasable<T>::value ? nullptr : &ItemPool::Destroy<T>;
+        auto item = new (GetPool(ItemPool::TypeId<T>(), sizeof(T), destroy).Allocate()) T(this);
+        Own(item);
+        return item;
+    }
 
-    void SendToFront(std::shared_ptr<Item> item);
-    void Save(const wxString &filename);
-    void Load(const wxString &filename);
+    Item *Get(ItemHandle handle) const;
+    Sprite *Retain(const std::shared_ptr<Sprite> &sprite);
+    Sprite *Retain(const Species &species);
+
+    void Add(Item *item);
+
+    Item *HitTest(int x, int y);
+    std::vector<Item*> ItemsNear(double x, double y, double radius);
+    void FindFreeLocation(double &x, double &y);
+
+    void SendToFront(Item *item);
+    void SendToBack(Item *item);
+    void Raise(Item *item);
+    void Lower(Item *item);
+    bool Save(const wxString &filename);
+    bool SaveBinary(const wxString &filename);
+    bool Load(const wxString &filename);
+    void GetTankData(TankData &data);
+    bool SetTankData(const TankData &data, const std::function<bool(double progress)> &progress = nullptr);
+    bool SetTankData(const AquaBinaryReader &reader,
+            const std::function<bool(double progress)> &progress = nullptr);
+    void SwapItems(Aquarium &other);
     void Clear();
     void Update(double elapsed);
+    void Advance(double elapsed);
+
+    void SetUpdateThreads(int threads);
+
+    /**
+     * Get the number of threads Update runs on
+     * @return Thread count, 1 if Update is serial
+     */
+    int GetUpdateThreads() const { return mPool != nullptr ? mPool->GetThreadCount() : 1; }
+
+    /**
+     * Set the number of items in each chunk of a parallel Update
+     * @param grain Items per chunk
+     */
+    void SetGrainSize(int grain) { mGrainSize = grain; }
+
+    /**
+     * Get the number of items in each chunk of a parallel Update
+     * @return Items per chunk
+     */
+    int GetGrainSize() const { return mGrainSize; }
+
+    /**
+     * Indicate that an item has changed location
+     * @param item The item that moved
+     * @param oldX X location the item was drawn at before the move
+     * @param oldY Y location the item was drawn at before the move
+     */
+    void OnItemMoved(Item *item, double oldX, double oldY);
+    void OnItemChanged(Item *item);
 
     /**
      * Get the width of the aquarium
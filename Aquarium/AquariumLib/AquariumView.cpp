@@ -5,13 +5,11 @@
 #include "pch.h"
 #include "AquariumView.h"
 #include "ids.h"
-#include "FishBeta.h"
 #include "Aquarium.h"
-#include "SpartyFish.h"
-#include "StinkyFish.h"
-#include "DecorCastle.h"
 #include "Item.h"
+#include "SpeciesRegistry.h"
 #include <wx/dcbuffer.h>
+#include <wx/filename.h>
 
 using namespace std;
 
@@ -24,22 +22,70 @@ const int FrameDuration = 30;
  */
 void AquariumView::OnPaint(wxPaintEvent& event)
 {
-    // Compute the time that has elapsed
-    // since the last call to OnPaint.
-    auto newTime = mStopWatch.Time();
-    auto elapsed = (double)(newTime - mTime) * 0.001;
-    mTime = newTime;
-
-    mAquarium.Update(elapsed);
-
     wxAutoBufferedPaintDC dc(this);
 
     wxBrush background(*wxWHITE);
-    dc.SetBackground(background);
-    dc.Clear();
+    dc.SetBrush(background);
+    dc.SetPen(*wxTRANSPARENT_PEN);
+
+    // Only clear and redraw the parts of the window that were
+    // invalidated. This draws the latest snapshot, so it never
+    // waits for the simulation thread.
+    auto &region = GetUpdateRegion();
+    mPaintRects.clear();
+    for (wxRegionIterator rects(region); rects; rects++)
+    {
+        mPaintRects.push_back(rects.GetRect());
+    }
+
+    dc.SetDeviceClippingRegion(region);
+    for (const auto &rect : mPaintRects)
+    {
+        dc.DrawRectangle(rect);
+    }
+
+    mAquarium.DrawSnapshot(&dc, mPaintRects);
+    dc.DestroyClippingRegion();
+}
+
+/**
+ * Make changes to the aquarium visible after an edit.
+ * Call this with the aquarium mutex held.
+ */
+void AquariumView::Publish()
+{
+    mAquarium.UpdateStaticLayer();
+    mAquarium.Publish();
+    RefreshDamage();
+}
+
+/**
+ * Invalidate the parts of the window the aquarium
+ * says have changed.
+ */
+void AquariumView::RefreshDamage()
+{
+    if (mAquarium.TakeDamage(mDamage))
+    {
+        Refresh();
+        return;
+    }
 
-    mAquarium.OnDraw(&dc);
+    for (const auto &rect : mDamage)
+    {
+        RefreshRect(rect, false);
+    }
+}
+/**
+ * Destructor
+ *
+ * Stops the simulation before any items are destroyed.
+ */
+AquariumView::~AquariumView()
+{
+    mSimulation.Stop();
 }
+
 /**
  * Initialize the aquarium view class.
  * @param parent The parent window for this class
@@ -47,69 +93,43 @@ void AquariumView::OnPaint(wxPaintEvent& event)
 void AquariumView::Initialize(wxFrame* parent)
 {
     Create(parent, wxID_ANY);
+    mFrame = parent;
     SetBackgroundStyle(wxBG_STYLE_PAINT);
     Bind(wxEVT_PAINT, &AquariumView::OnPaint, this);
 
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddFishBetaFish, this, IDM_ADDFISHBETA);
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddSpartyFish, this, IDM_ADDFISHNEMO);
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddStinkyFish, this, IDM_ADDFISHANGEL);
-    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddDecorCastle, this, IDM_ADDDECORCASTLE);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddSpecies, this,
+            IDM_ADDSPECIES, IDM_ADDSPECIES + SpeciesRegistry::Instance().GetCount() - 1);
     parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnFileSaveAs, this, wxID_SAVEAS);
     parent->Bind(wxEVT_COMMAND_MENU_SELECTED,&AquariumView::OnFileOpen, this, wxID_OPEN);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnFileCancel, this, IDM_FILECANCEL);
 
     Bind(wxEVT_LEFT_DOWN, &AquariumView::OnLeftDown, this);
     Bind(wxEVT_LEFT_UP, &AquariumView::OnLeftUp, this);
     Bind(wxEVT_MOTION, &AquariumView::OnMouseMove, this);
     Bind(wxEVT_TIMER, &AquariumView::OnTimer, this);
 
+    {
+        lock_guard<mutex> lock(mAquarium.GetMutex());
+        Publish();
+    }
+
+    mSimulation.Start();
     mTimer.SetOwner(this);
     mTimer.Start(FrameDuration);
-    mStopWatch.Start();
 }
 
 
 /**
- * Menu handler for Add Fish>Beta Fish
- * @param event Mouse event
- */
-void AquariumView::OnAddFishBetaFish(wxCommandEvent& event)
-{
-    auto fish = make_shared<FishBeta>(&mAquarium);
-    mAquarium.Add(fish);
-    Refresh();
-
-}
-
-/**
- * Menu handler for add Fish>Sparty Fish
- * @param event Mouse event
- */
-void AquariumView::OnAddSpartyFish(wxCommandEvent& event)
-{
-    auto fish = make_shared<SpartyFish>(&mAquarium);
-    mAquarium.Add(fish);
-    Refresh();
-}
-/**
- * Menu handler for add Fish>Stinky Fish
- * @param event Mouse event
+ * Menu handler for the Add Fish and Add Decor menu items
+ * @param event Menu event, its id selects the species
  */
-void AquariumView::OnAddStinkyFish(wxCommandEvent& event)
+void AquariumView::OnAddSpecies(wxCommandEvent& event)
 {
-    auto fish = make_shared<StinkyFish>(&mAquarium);
-    mAquarium.Add(fish);
-    Refresh();
-}
+    auto &species = SpeciesRegistry::Instance().GetSpecies(event.GetId() - IDM_ADDSPECIES);
 
-/**
- * Menu handler for add decor>castle
- * @param event Mouse event
- */
- void AquariumView::OnAddDecorCastle(wxCommandEvent& event)
-{
-     auto castle = make_shared<DecorCastle>(&mAquarium);
-     mAquarium.Add(castle);
-     Refresh();
+    lock_guard<mutex> lock(mAquarium.GetMutex());
+    mAquarium.Add(species.Create(&mAquarium));
+    Publish();
 }
 
 /**
@@ -118,16 +138,35 @@ void AquariumView::OnAddStinkyFish(wxCommandEvent& event)
  */
  void AquariumView::OnFileSaveAs(wxCommandEvent& event)
  {
+     // Starting another job would cancel the running one
+     UpdateJob();
+     if (mJob != nullptr)
+     {
+         wxMessageBox(L"Wait for the current load or save to finish, or cancel it first");
+         return;
+     }
+
      wxFileDialog saveFileDialog(this, _("Save Aquarium file"), "", "",
-             "Aquarium Files (*.aqua)|*.aqua", wxFD_SAVE|wxFD_OVERWRITE_PROMPT);
+             "Aquarium Files (*.aqua)|*.aqua|Binary Aquarium Files (*.aquab)|*.aquab",
+             wxFD_SAVE|wxFD_OVERWRITE_PROMPT);
      if (saveFileDialog.ShowModal() == wxID_CANCEL)
      {
          return;
      }
 
      auto filename = saveFileDialog.GetPath();
+     auto format = saveFileDialog.GetFilterIndex() == 1 ? TankFile::Format::Binary : TankFile::Format::Xml;
+
+     // Copying the items out is quick, the
+     // file is written in the background
+     TankData data;
+     {
+         lock_guard<mutex> lock(mAquarium.GetMutex());
+         mAquarium.GetTankData(data);
+     }
 
-     mAquarium.Save(filename);
+     mJob = make_unique<FileJob>(filename, move(data), format);
+     UpdateJob();
  }
 
 /**
@@ -136,16 +175,108 @@ void AquariumView::OnAddStinkyFish(wxCommandEvent& event)
 */
 void AquariumView::OnFileOpen(wxCommandEvent& event)
 {
+    // Starting another job would cancel the running one
+    UpdateJob();
+    if (mJob != nullptr)
+    {
+        wxMessageBox(L"Wait for the current load or save to finish, or cancel it first");
+        return;
+    }
+
     wxFileDialog loadFileDialog(this, _("Load Aquarium file"), "", "",
-            "Aquarium Files (*.aqua)|*.aqua", wxFD_OPEN);
+            "Aquarium Files (*.aqua;*.aquab)|*.aqua;*.aquab", wxFD_OPEN);
     if (loadFileDialog.ShowModal() == wxID_CANCEL)
     {
         return;
     }
 
     auto filename = loadFileDialog.GetPath();
-    mAquarium.Load(filename);
-    Refresh();
+
+    // The file is read and its items built in the background,
+    // and they replace the current ones when it is done
+    mJob = make_unique<FileJob>(filename, make_unique<Aquarium>());
+    UpdateJob();
+}
+
+/**
+ * File>Cancel menu handler, stops any load or save
+ * @param event Menu event
+ */
+void AquariumView::OnFileCancel(wxCommandEvent& event)
+{
+    if (mJob != nullptr)
+    {
+        mJob->Cancel();
+    }
+}
+
+/**
+ * Show the progress of the background load or
+ * save, and finish it once it is done
+ */
+void AquariumView::UpdateJob()
+{
+    if (mJob == nullptr)
+    {
+        return;
+    }
+
+    if (mJob->IsDone())
+    {
+        FinishJob();
+        return;
+    }
+
+    wxFileName name(mJob->GetFilename());
+    mFrame->SetStatusText(wxString::Format(L"%s %s... %d%%",
+            mJob->IsLoad() ? L"Loading" : L"Saving",
+            name.GetFullName(), int(mJob->GetProgress() * 100)));
+}
+
+/**
+ * Finish a background load or save that is done.
+ *
+ * A load has built the items in an aquarium of its own on
+ * the job thread, so all that is left here is to swap them
+ * into ours, which does not depend on the number of items.
+ * The old items are freed with that aquarium after the lock
+ * is released.
+ */
+void AquariumView::FinishJob()
+{
+    auto job = move(mJob);
+    wxFileName name(job->GetFilename());
+
+    if (!job->Succeeded())
+    {
+        if (job->IsCancelled())
+        {
+            mFrame->SetStatusText(L"Cancelled");
+        }
+        else
+        {
+            mFrame->SetStatusText(L"");
+            wxMessageBox(job->IsLoad() ? L"Unable to load Aquarium file" : L"Unable to save Aquarium file");
+        }
+
+        return;
+    }
+
+    if (!job->IsLoad())
+    {
+        mFrame->SetStatusText(wxString::Format(L"Saved %s", name.GetFullName()));
+        return;
+    }
+
+    auto loaded = job->TakeAquarium();
+    {
+        lock_guard<mutex> lock(mAquarium.GetMutex());
+        mGrabbedItem = ItemHandle();
+        mAquarium.SwapItems(*loaded);
+        Publish();
+    }
+
+    mFrame->SetStatusText(wxString::Format(L"Loaded %s", name.GetFullName()));
 }
 
 /**
@@ -154,10 +285,17 @@ void AquariumView::OnFileOpen(wxCommandEvent& event)
  */
 void AquariumView::OnLeftDown(wxMouseEvent &event)
 {
-    mGrabbedItem = mAquarium.HitTest(event.GetX(), event.GetY());
-    if (mGrabbedItem != nullptr)
+    lock_guard<mutex> lock(mAquarium.GetMutex());
+    auto item = mAquarium.HitTest(event.GetX(), event.GetY());
+    if (item != nullptr)
+    {
+        mGrabbedItem = item->GetHandle();
+        mAquarium.SendToFront(item);
+        Publish();
+    }
+    else
     {
-        mAquarium.SendToFront(mGrabbedItem);
+        mGrabbedItem = ItemHandle();
     }
 
 }
@@ -179,28 +317,38 @@ void AquariumView::OnLeftUp(wxMouseEvent &event)
 void AquariumView::OnMouseMove(wxMouseEvent &event)
 {
     // See if an item is currently being moved by the mouse
-    if (mGrabbedItem != nullptr)
+    if (!mGrabbedItem.IsNull())
     {
+        lock_guard<mutex> lock(mAquarium.GetMutex());
+
         // If an item is being moved, we only continue to
-        //move it while the left button is down.
-        if (event.LeftIsDown())
+        //move it while the left button is down. The item
+        // is gone if the aquarium was loaded meanwhile.
+        auto item = mAquarium.Get(mGrabbedItem);
+        if (item != nullptr && event.LeftIsDown())
         {
-            mGrabbedItem->SetLocation(event.GetX(), event.GetY());
+            item->SetLocation(event.GetX(), event.GetY());
         }
         else
         {
             // When the left button is released, we release the
             // item
-            mGrabbedItem = nullptr;
+            mGrabbedItem = ItemHandle();
         }
 
-        // Force the screen to redraw
-        Refresh();
+        // Redraw where the item was and is now
+        Publish();
     }
 
 }
 
+/**
+ * Timer handler, redraws what the simulation
+ * thread has changed since the last timer event
+ * @param event Timer event
+ */
 void AquariumView::OnTimer(wxTimerEvent& event)
 {
-    Refresh();
+    RefreshDamage();
+    UpdateJob();
 }
\ No newline at end of file
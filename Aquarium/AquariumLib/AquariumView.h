@@ -8,6 +8,8 @@
 #ifndef AQUARIUM_AQUARIUMVIEW_H
 #define AQUARIUM_AQUARIUMVIEW_H
 #include "Aquarium.h"
+#include "SimulationThread.h"
+#include "FileJob.h"
 
 /**
  * View class for our aquarium
@@ -18,30 +20,44 @@ private:
     /// An object that describes our aquarium
     Aquarium  mAquarium;
 
-    /// The timer that allows for animation
+    /// Advances mAquarium
+    SimulationThread mSimulation {&mAquarium};
+
+    /// The timer that redraws what the simulation changed
     wxTimer mTimer;
 
-    /// Stopwatch used to measure elapsed time
-    wxStopWatch mStopWatch;
+    /// Areas of the aquarium we are invalidating
+    std::vector<wxRect> mDamage;
+
+    /// Rectangles of the update region being painted
+    std::vector<wxRect> mPaintRects;
+
+    /// The frame whose status bar shows file progress
+    wxFrame *mFrame = nullptr;
 
-    /// The last stopwatch time
-    long mTime = 0;
+    /// Load or save running in the background, if any
+    std::unique_ptr<FileJob> mJob;
+
+    void Publish();
+    void RefreshDamage();
+    void UpdateJob();
+    void FinishJob();
 
 public:
+    virtual ~AquariumView();
+
     void Initialize(wxFrame* parent);
-    void OnAddFishBetaFish(wxCommandEvent& event);
+    void OnAddSpecies(wxCommandEvent& event);
     void OnLeftDown(wxMouseEvent &event);
     void OnLeftUp(wxMouseEvent &event);
     void OnMouseMove(wxMouseEvent &event);
-    void OnAddSpartyFish(wxCommandEvent& event);
-    void OnAddStinkyFish(wxCommandEvent& event);
-    void OnAddDecorCastle(wxCommandEvent& event);
     void OnFileSaveAs(wxCommandEvent& event);
     void OnFileOpen(wxCommandEvent& event);
+    void OnFileCancel(wxCommandEvent& event);
     void OnTimer(wxTimerEvent& event);
 
-    /// Any item we are currently dragging
-    std::shared_ptr<Item> mGrabbedItem;
+    /// Any item we are currently dragging, null if none
+    ItemHandle mGrabbedItem;
 
 };
 
@@ -6,6 +6,7 @@
 #include "pch.h"
 #include "DecorCastle.h"
 #include "Aquarium.h"
+#include "SpeciesRegistry.h"
 #include <string>
 
 using namespace std;
@@ -13,28 +14,34 @@ using namespace std;
 /// Castle filename
 const wstring DecorCastleImageName = L"images/castle.png";
 
+/// Tag castles are saved with
+const string DecorCastleType = "castle";
+
+/**
+ * Get the castle species. Looked up once, as the registry
+ * never moves a species.
+ * @return The registered species
+ */
+static const Species &DecorCastleSpecies()
+{
+    static const Species &species = SpeciesRegistry::Instance().Get(DecorCastleType);
+    return species;
+}
+
 /**
  * Constructor
  * @param aquarium Aquarium this castle is a member of
  */
-DecorCastle::DecorCastle(Aquarium *aquarium) : Item(aquarium, DecorCastleImageName)
+DecorCastle::DecorCastle(Aquarium *aquarium) : Item(aquarium, DecorCastleSpecies())
 {
 }
 
 /**
- * Save this castle to an XML node
- * @param node The parent node we are going to be a child of
- * @return
+ * Register the castle species
+ * @param registry Registry to add the species to
  */
-wxXmlNode* DecorCastle::XmlSave(wxXmlNode* node)
+void DecorCastle::Register(SpeciesRegistry &registry)
 {
-    auto itemNode = Item::XmlSave(node);
-
-    itemNode->AddAttribute(L"type", L"castle");
-
-    return itemNode;
+    registry.Add(DecorCastleType, DecorCastleImageName, L"&Castle", L"Add a Castle", Species::Menu::Decor,
+            [](Aquarium *aquarium) -> Item* { return aquarium->Create<DecorCastle>(); });
 }
-
-
-
-
@@ -10,6 +10,8 @@
 
 #include "Fish.h"
 
+class SpeciesRegistry;
+
 class DecorCastle : public Item {
 private:
 
@@ -25,8 +27,10 @@ public:
 
     DecorCastle(Aquarium* aquarium);
 
-    wxXmlNode* XmlSave(wxXmlNode* node) override;
+    static void Register(SpeciesRegistry &registry);
 
 };
 
+AQUARIUM_POOL_RELEASABLE(DecorCastle);
+
 #endif //AQUARIUM_DECORCASTLE_H
@@ -0,0 +1,272 @@
+/**
+ * @file DrawOrder.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "DrawOrder.h"
+#include "Item.h"
+
+using namespace std;
+
+/// Fewest tombstones we bother to squeeze out
+const size_t MinCompactTombstones = 64;
+
+/**
+ * Add an item in front of all the others
+ * @param item Item to add
+ */
+void DrawOrder::PushFront(Item *item)
+{
+    item->SetZOrder(mFirst + (int64_t)mItems.size());
+    mItems.push_back(item);
+    mNext.push_back(0);
+    mPrev.push_back(0);
+}
+
+/**
+ * Add an item behind all the others
+ * @param item Item to add
+ */
+void DrawOrder::PushBack(Item *item)
+{
+    mFirst--;
+    item->SetZOrder(mFirst);
+    mItems.push_front(item);
+    mNext.push_front(0);
+    mPrev.push_front(0);
+}
+
+/**
+ * Find where an item is in mItems
+ * @param item Item to find
+ * @return Index in mItems, or -1 if the item is not here
+ */
+int64_t DrawOrder::IndexOf(const Item *item) const
+{
+    auto index = item->GetZOrder() - mFirst;
+    if (index >= 0 && index < (int64_t)mItems.size() && mItems[index] == item)
+    {
+        return index;
+    }
+
+    return -1;
+}
+
+/**
+ * Turn the slot of an item that is moving into a tombstone
+ * @param index Index of the slot in mItems
+ */
+void DrawOrder::Bury(int64_t index)
+{
+    mItems[index] = nullptr;
+    mNext[index] = mFirst + index + 1;
+    mPrev[index] = mFirst + index - 1;
+    mTombstones++;
+}
+
+/**
+ * Find the first live slot from an index on, following
+ * the links of the tombstones on the way.
+ *
+ * Every tombstone passed is then linked straight to the
+ * slot found, so the next search from any of them takes
+ * one step.
+ *
+ * @param index Index to start at
+ * @param links mNext to search forward or mPrev to search back
+ * @return Index of the live slot, or an index outside
+ * mItems if there is none in that direction
+ */
+int64_t DrawOrder::FindLive(int64_t index, deque<int64_t> &links)
+{
+    auto size = (int64_t)mItems.size();
+    auto found = index;
+    while (found >= 0 && found < size && mItems[found] == nullptr)
+    {
+        found = links[found] - mFirst;
+    }
+
+    // Slots only ever become tombstones, so the links
+    // stay correct as live items are swapped about
+    auto key = mFirst + found;
+    while (index != found)
+    {
+        auto next = links[index] - mFirst;
+        links[index] = key;
+        index = next;
+    }
+
+    return found;
+}
+
+/**
+ * Is an item in the draw order?
+ * @param item Item to test
+ * @return true if the item is here
+ */
+bool DrawOrder::Contains(const Item *item) const
+{
+    return IndexOf(item) >= 0;
+}
+
+/**
+ * Move an item in front of all the others
+ * @param item Item to move
+ * @return false if the item is not here
+ */
+bool DrawOrder::SendToFront(const Item *item)
+{
+    auto index = IndexOf(item);
+    if (index < 0)
+    {
+        return false;
+    }
+
+    if (index == (int64_t)mItems.size() - 1)
+    {
+        return true;
+    }
+
+    auto moved = mItems[index];
+    Bury(index);
+    PushFront(moved);
+    Compact();
+    return true;
+}
+
+/**
+ * Move an item behind all the others
+ * @param item Item to move
+ * @return false if the item is not here
+ */
+bool DrawOrder::SendToBack(const Item *item)
+{
+    auto index = IndexOf(item);
+    if (index < 0)
+    {
+        return false;
+    }
+
+    if (index == 0)
+    {
+        return true;
+    }
+
+    auto moved = mItems[index];
+    Bury(index);
+    PushBack(moved);
+    Compact();
+    return true;
+}
+
+/**
+ * Move an item in front of the next item
+ * @param item Item to move
+ * @return false if the item is not here or already in front
+ */
+bool DrawOrder::Raise(const Item *item)
+{
+    auto index = IndexOf(item);
+    if (index < 0)
+    {
+        return false;
+    }
+
+    auto next = FindLive(index + 1, mNext);
+    if (next >= (int64_t)mItems.size())
+    {
+        return false;
+    }
+
+    Swap(index, next);
+    return true;
+}
+
+/**
+ * Move an item behind the previous item
+ * @param item Item to move
+ * @return false if the item is not here or already at the back
+ */
+bool DrawOrder::Lower(const Item *item)
+{
+    auto index = IndexOf(item);
+    if (index < 0)
+    {
+        return false;
+    }
+
+    auto prev = FindLive(index - 1, mPrev);
+    if (prev < 0)
+    {
+        return false;
+    }
+
+    Swap(index, prev);
+    return true;
+}
+
+/**
+ * Remove all of the items
+ */
+void DrawOrder::Clear()
+{
+    mItems.clear();
+    mNext.clear();
+    mPrev.clear();
+    mFirst = 0;
+    mTombstones = 0;
+}
+
+/**
+ * Exchange all of the items with another draw order.
+ * The items keep their keys.
+ * @param other Draw order to exchange with
+ */
+void DrawOrder::Exchange(DrawOrder &other)
+{
+    mItems.swap(other.mItems);
+    mNext.swap(other.mNext);
+    mPrev.swap(other.mPrev);
+    swap(mFirst, other.mFirst);
+    swap(mTombstones, other.mTombstones);
+}
+
+/**
+ * Exchange two items and their keys
+ * @param a Index of one item
+ * @param b Index of the other item
+ */
+void DrawOrder::Swap(int64_t a, int64_t b)
+{
+    swap(mItems[a], mItems[b]);
+    mItems[a]->SetZOrder(mFirst + a);
+    mItems[b]->SetZOrder(mFirst + b);
+}
+
+/**
+ * Squeeze out the tombstones once there are as many
+ * of them as items, renumbering the keys
+ */
+void DrawOrder::Compact()
+{
+    if (mTombstones < MinCompactTombstones || mTombstones < GetCount())
+    {
+        return;
+    }
+
+    deque<Item*> items;
+    for (auto item : mItems)
+    {
+        if (item != nullptr)
+        {
+            item->SetZOrder(mFirst + (int64_t)items.size());
+            items.push_back(item);
+        }
+    }
+
+    mItems.swap(items);
+    mNext.assign(mItems.size(), 0);
+    mPrev.assign(mItems.size(), 0);
+    mTombstones = 0;
+}
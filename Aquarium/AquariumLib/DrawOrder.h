@@ -0,0 +1,128 @@
+/**
+ * @file DrawOrder.h
+ * @author joeyv
+ *
+ * The items of an aquarium in the order they are drawn.
+ */
+
+#ifndef AQUARIUM_DRAWORDER_H
+#define AQUARIUM_DRAWORDER_H
+
+#include <cstdint>
+#include <deque>
+
+class Item;
+
+/**
+ * The items of an aquarium in the order they are drawn.
+ *
+ * Items are kept in a deque from back to front. The aquarium
+ * owns the items, so the deque holds plain pointers and
+ * going through it costs no reference counting. Each item's
+ * z order key is its position in the deque plus an offset,
+ * so finding an item takes no search. Moving an item to the
+ * front or back leaves an empty tombstone where it was and
+ * adds it at that end, in constant time. The tombstones are
+ * squeezed out once there are as many of them as items,
+ * which renumbers the keys.
+ *
+ * Raising or lowering an item swaps it with its nearest live
+ * neighbour, which may be past a long run of tombstones. Each
+ * tombstone keeps links to the keys of the slots after and
+ * before it, and the links are shortened to point straight at
+ * the live slot found each time they are followed, so finding
+ * a neighbour takes amortised O(log n) steps rather than one
+ * step per tombstone.
+ */
+class DrawOrder {
+private:
+    /// The items from back to front, null where an item was moved from
+    std::deque<Item*> mItems;
+
+    /// For each tombstone, the key of a later slot with no live
+    /// item between them. Unused for live slots.
+    std::deque<int64_t> mNext;
+
+    /// For each tombstone, the key of an earlier slot with no
+    /// live item between them. Unused for live slots.
+    std::deque<int64_t> mPrev;
+
+    /// Z order key of mItems[0]
+    int64_t mFirst = 0;
+
+    /// Number of null entries in mItems
+    size_t mTombstones = 0;
+
+    int64_t IndexOf(const Item *item) const;
+    void Bury(int64_t index);
+    int64_t FindLive(int64_t index, std::deque<int64_t> &links);
+    void Swap(int64_t a, int64_t b);
+    void Compact();
+
+public:
+    DrawOrder() = default;
+
+    /// Copy constructor (disabled)
+    DrawOrder(const DrawOrder &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const DrawOrder &) = delete;
+
+    /**
+     * Iterator over the items from back to front
+     * that skips the tombstones
+     */
+    class Iterator {
+    private:
+        /// Current position
+        std::deque<Item*>::const_iterator mPos;
+
+        /// End of the items
+        std::deque<Item*>::const_iterator mEnd;
+
+        /// Move forward past any tombstones
+        void Skip() { while (mPos != mEnd && *mPos == nullptr) { ++mPos; } }
+
+    public:
+        /**
+         * Constructor
+         * @param pos Starting position
+         * @param end End of the items
+         */
+        Iterator(std::deque<Item*>::const_iterator pos,
+                std::deque<Item*>::const_iterator end) : mPos(pos), mEnd(end) { Skip(); }
+
+        /** Get the item @return The current item */
+        Item *operator*() const { return *mPos; }
+
+        /** Move to the next item @return This iterator */
+        Iterator &operator++() { ++mPos; Skip(); return *this; }
+
+        /** Compare iterators @param other Other iterator @return true if different */
+        bool operator!=(const Iterator &other) const { return mPos != other.mPos; }
+    };
+
+    /** Start of the items @return Iterator at the back most item */
+    Iterator begin() const { return Iterator(mItems.begin(), mItems.end()); }
+
+    /** End of the items @return Iterator past the front most item */
+    Iterator end() const { return Iterator(mItems.end(), mItems.end()); }
+
+    /**
+     * Get the number of items
+     * @return Item count
+     */
+    size_t GetCount() const { return mItems.size() - mTombstones; }
+
+    void PushFront(Item *item);
+    void PushBack(Item *item);
+    bool Contains(const Item *item) const;
+    bool SendToFront(const Item *item);
+    bool SendToBack(const Item *item);
+    bool Raise(const Item *item);
+    bool Lower(const Item *item);
+    void Clear();
+    void Exchange(DrawOrder &other);
+};
+
+#endif //AQUARIUM_DRAWORDER_H
@@ -0,0 +1,172 @@
+/**
+ * @file FileJob.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "FileJob.h"
+#include "Aquarium.h"
+#include "SpeciesRegistry.h"
+#include "AquaBinaryReader.h"
+#include <algorithm>
+
+using namespace std;
+
+/// Part of the progress of a load that builds an aquarium
+/// taken up by reading the file, the rest is building items
+const double ReadShare = 0.75;
+
+/**
+ * Constructor, starts reading a tank file.
+ *
+ * Large XML files are parsed on one thread per core.
+ * @param filename File to read
+ */
+FileJob::FileJob(const wxString &filename) : mFilename(filename), mLoad(true)
+{
+    mThread = thread([this]() {
+        Finish(Read(1));
+    });
+}
+
+/**
+ * Constructor, starts reading a tank file and building
+ * its items in an aquarium.
+ *
+ * Call this on the main thread. Making a sprite builds
+ * bitmaps, so the sprites of every species are made here
+ * and held until the job is destroyed. The thread then only
+ * creates items, fills in their Kinematics and adds them to
+ * the spatial grid, none of which needs the main thread.
+ * The items of a binary file are built straight from its
+ * mapping, without going through the job's TankData.
+ *
+ * @param filename File to read
+ * @param aquarium Empty aquarium to build the items in,
+ * which nothing else may use until the job is done
+ */
+FileJob::FileJob(const wxString &filename, unique_ptr<Aquarium> aquarium) :
+        mFilename(filename), mLoad(true), mAquarium(move(aquarium))
+{
+    auto &registry = SpeciesRegistry::Instance();
+    for (int i = 0; i < registry.GetCount(); i++)
+    {
+        mSprites.push_back(registry.GetSpecies(i).GetSprite());
+    }
+
+    mThread = thread([this]() {
+        // A binary file is built straight from its mapping,
+        // so building is the whole job
+        AquaBinaryReader binary(mFilename);
+        if (binary.IsBinary())
+        {
+            Finish(mAquarium->SetTankData(binary, [this](double progress) {
+                mProgress = progress;
+                return !mCancel;
+            }));
+            return;
+        }
+
+        auto succeeded = Read(ReadShare) && mAquarium->SetTankData(mData, [this](double progress) {
+            mProgress = ReadShare + progress * (1 - ReadShare);
+            return !mCancel;
+        });
+
+        // The items hold everything we need now
+        mData = TankData();
+        Finish(succeeded);
+    });
+}
+
+/**
+ * Constructor, starts writing a tank file
+ * @param filename File to write
+ * @param data Items to write
+ * @param format Format to write the file in
+ */
+FileJob::FileJob(const wxString &filename, TankData data, TankFile::Format format) :
+        mFilename(filename), mLoad(false), mData(move(data))
+{
+    mThread = thread([this, format]() {
+        auto succeeded = TankFile::Write(mFilename, mData, format, [this](double progress) {
+            mProgress = progress;
+            return !mCancel;
+        });
+
+        Finish(succeeded);
+    });
+}
+
+/**
+ * Destructor, cancels the job and waits for the thread
+ */
+FileJob::~FileJob()
+{
+    Cancel();
+    Wait();
+}
+
+/**
+ * Read the file into mData. Called on the thread.
+ * @param share Part of the job's progress reading takes up
+ * @return true if the file was read
+ */
+bool FileJob::Read(double share)
+{
+    auto threads = max(1, (int)thread::hardware_concurrency());
+    return TankFile::Read(mFilename, mData, [this, share](double progress) {
+        mProgress = progress * share;
+        return !mCancel;
+    }, threads);
+}
+
+/**
+ * Record the result of the job. Called on the thread.
+ *
+ * A cancelled load has not succeeded even if it read the
+ * whole file, so its items are not swapped in. A save that
+ * returned true has already renamed its file over the old
+ * one, so it has succeeded even if it was cancelled too
+ * late to stop.
+ *
+ * @param succeeded True if the file was read or written
+ */
+void FileJob::Finish(bool succeeded)
+{
+    mSucceeded = succeeded && (!mLoad || !mCancel);
+    if (mSucceeded)
+    {
+        mProgress = 1;
+    }
+
+    mDone = true;
+}
+
+/**
+ * Ask the job to stop. It stops at its next progress report.
+ */
+void FileJob::Cancel()
+{
+    mCancel = true;
+}
+
+/**
+ * Take the aquarium a load built its items in. Only
+ * call this once IsDone and Succeeded return true.
+ * @return The aquarium, or null if the job did not build one
+ */
+unique_ptr<Aquarium> FileJob::TakeAquarium()
+{
+    return move(mAquarium);
+}
+
+/**
+ * Wait for the thread to finish
+ */
+void FileJob::Wait()
+{
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+}
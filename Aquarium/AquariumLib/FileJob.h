@@ -0,0 +1,136 @@
+/**
+ * @file FileJob.h
+ * @author joeyv
+ *
+ * Reads or writes a tank file on its own thread.
+ */
+
+#ifndef AQUARIUM_FILEJOB_H
+#define AQUARIUM_FILEJOB_H
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "TankData.h"
+#include "TankFile.h"
+
+class Aquarium;
+class Sprite;
+
+/**
+ * Reads or writes a tank file on its own thread.
+ *
+ * The job works only on its own TankData, so the aquarium
+ * keeps animating while it runs. Poll IsDone, then take the
+ * loaded data with GetData and put it into an aquarium.
+ * A load can also build the items in an aquarium of its
+ * own, so only swapping them in is left for the main thread.
+ * Destroying the job cancels it and waits for the thread.
+ */
+class FileJob {
+private:
+    /// The file we are reading or writing
+    wxString mFilename;
+
+    /// True if this job reads the file, false if it writes it
+    bool mLoad;
+
+    /// Data read from the file, or the data to write to it
+    TankData mData;
+
+    /// Aquarium a load builds the items in, or null
+    std::unique_ptr<Aquarium> mAquarium;
+
+    /// Sprites of every species, held while the thread builds
+    /// items so it never has to make one
+    std::vector<std::shared_ptr<Sprite>> mSprites;
+
+    /// Fraction of the job done, from 0 to 1
+    std::atomic<double> mProgress {0};
+
+    /// Set to ask the thread to stop
+    std::atomic<bool> mCancel {false};
+
+    /// Set by the thread when it has finished
+    std::atomic<bool> mDone {false};
+
+    /// True if a load finished without an error or being
+    /// cancelled, or a save wrote its file. Valid once mDone is set.
+    bool mSucceeded = false;
+
+    /// The thread doing the job
+    std::thread mThread;
+
+    bool Read(double share);
+    void Finish(bool succeeded);
+
+public:
+    explicit FileJob(const wxString &filename);
+    FileJob(const wxString &filename, std::unique_ptr<Aquarium> aquarium);
+    FileJob(const wxString &filename, TankData data, TankFile::Format format);
+    virtual ~FileJob();
+
+    /// Default constructor (disabled)
+    FileJob() = delete;
+
+    /// Copy constructor (disabled)
+    FileJob(const FileJob &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const FileJob &) = delete;
+
+    void Cancel();
+    void Wait();
+
+    /**
+     * Get the file this job reads or writes
+     * @return Filename
+     */
+    const wxString &GetFilename() const { return mFilename; }
+
+    /**
+     * Does this job read a file?
+     * @return true for a load, false for a save
+     */
+    bool IsLoad() const { return mLoad; }
+
+    /**
+     * Get how much of the job is done
+     * @return Fraction from 0 to 1
+     */
+    double GetProgress() const { return mProgress; }
+
+    /**
+     * Has the thread finished?
+     * @return true if the job has succeeded, failed or been cancelled
+     */
+    bool IsDone() const { return mDone; }
+
+    /**
+     * Has the job been asked to stop?
+     * @return true if Cancel was called
+     */
+    bool IsCancelled() const { return mCancel; }
+
+    /**
+     * Did the job finish without an error or being cancelled?
+     * A save cancelled after its file was written has still
+     * succeeded. Only call this once IsDone returns true.
+     * @return true if the file was read or written
+     */
+    bool Succeeded() const { return mSucceeded; }
+
+    /**
+     * Get the data read from the file. Only call
+     * this once IsDone returns true. A job that built
+     * an aquarium lets go of the data once it has.
+     * @return Reference to the loaded data
+     */
+    TankData &GetData() { return mData; }
+
+    std::unique_ptr<Aquarium> TakeAquarium();
+};
+
+#endif //AQUARIUM_FILEJOB_H
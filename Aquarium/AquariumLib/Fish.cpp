@@ -7,90 +7,64 @@
 #include "Fish.h"
 #include "Aquarium.h"
 
-/// Maximum speed in the X direction in
-/// in pixels per second
-const double MaxSpeedX = 50;
-
-/// Minimum speed in the X direction in
-/// pixels per second
-const double MinSpeedX = 20;
-
 /**
- * Constructor
+ * Constructor. The fish is still until its species
+ * constructor or the tank it is loaded from sets its speed.
  * @param aquarium The aquarium we are in
- * @param filename Filename for the image we use
+ * @param species The species of this fish
  */
-Fish::Fish(Aquarium *aquarium, const std::wstring &filename) :
-        Item(aquarium, filename)
+Fish::Fish(Aquarium *aquarium, const Species &species) :
+        Item(aquarium, species)
 {
-    std::uniform_real_distribution<> distribution(MinSpeedX, MaxSpeedX);
-    mSpeedX = distribution(aquarium->GetRandom());
-    mSpeedY = distribution(aquarium->GetRandom());
+}
+
+/**
+ * Set the speed of the fish
+ * @param x Speed in the X direction in pixels per second
+ * @param y Speed in the Y direction in pixels per second
+ */
+void Fish::SetSpeed(double x, double y)
+{
+    GetKinematics()->SetSpeed(GetSlot(), x, y);
 }
 
 /**
  * Handle updates in time of our fish
  *
- * This is called before we draw and allows us to
- * move our fish. We add our speed times the amount
- * of time that has elapsed.
+ * This moves one fish. We add our speed times the amount
+ * of time that has elapsed. Aquarium::Update does the same
+ * for every fish at once through Kinematics::Integrate.
  * @param elapsed Time elapsed since the class call
  */
 void Fish::Update(double elapsed)
 {
-    SetLocation(GetX() + mSpeedX * elapsed,
-            GetY() + mSpeedY * elapsed);
+    double speedX = GetSpeedX();
+    double speedY = GetSpeedY();
+
+    SetLocation(GetX() + speedX * elapsed,
+            GetY() + speedY * elapsed);
 
-    if (mSpeedX > 0 && GetX() >= (GetAquarium()->GetWidth() - 10 - GetLength()/2))
+    if (speedX > 0 && GetX() >= (GetAquarium()->GetWidth() - 10 - GetLength()/2))
     {
-        mSpeedX = -mSpeedX;
+        speedX = -speedX;
         SetMirror(true);
     }
 
-    else if(mSpeedX < 0 && GetX() <= (10 + GetLength()/2))
+    else if(speedX < 0 && GetX() <= (10 + GetLength()/2))
     {
-        mSpeedX = -mSpeedX;
+        speedX = -speedX;
         SetMirror(false);
     }
 
-    if(mSpeedY > 0 && GetY() >= (GetAquarium()->GetHeight() - 10 - GetLength()/2))
+    if(speedY > 0 && GetY() >= (GetAquarium()->GetHeight() - 10 - GetLength()/2))
     {
-        mSpeedY = -mSpeedY;
+        speedY = -speedY;
     }
 
-    else if(mSpeedY < 0 && GetY() <= (10 + GetLength()/2))
+    else if(speedY < 0 && GetY() <= (10 + GetLength()/2))
     {
-        mSpeedY = -mSpeedY;
+        speedY = -speedY;
     }
-}
-
-/**
- * Save this item to an XML node
- * @param node The parent node we are going to be a child of
- * @return wxXmlNode that we saved the item into
- */
-wxXmlNode *Fish::XmlSave(wxXmlNode *node)
-{
-    auto itemNode = Item::XmlSave(node);
-
-    itemNode->AddAttribute(L"x-speed", wxString::FromDouble(mSpeedX));
-    itemNode->AddAttribute(L"y-speed", wxString::FromDouble(mSpeedY));
-
-    return itemNode;
-}
-
-/**
- * Load the attributes for an item node.
- *
- * Override this to load custom attributes
- * for specific items.
- *
- * @param node The Xml node we are loading the item from
- */
-void Fish::XmlLoad(wxXmlNode *node)
-{
-    Item::XmlLoad(node);
 
-    node->GetAttribute(L"x-speed", L"0").ToDouble(&mSpeedX);
-    node->GetAttribute(L"y-speed", L"0").ToDouble(&mSpeedY);
+    SetSpeed(speedX, speedY);
 }
\ No newline at end of file
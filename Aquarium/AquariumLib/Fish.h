@@ -27,22 +27,30 @@ private:
     /// Assignment operator
     void operator=(const Fish &) = delete;
 
-    /// Fish speed in the X direction
-    /// in pixels per second
-    double mSpeedX;
-
-    /// Fish speed in the Y direction
-    /// in pixels per second
-    double mSpeedY;
-
 protected:
-    Fish(Aquarium *aquarium, const std::wstring &filename);
+    Fish(Aquarium *aquarium, const Species &species);
 
 public:
     void Update(double elapsed) override;
-    wxXmlNode *XmlSave(wxXmlNode *node) override;
-    void XmlLoad(wxXmlNode *node) override;
-    void SetSpeed(double x, double y){mSpeedX = x; mSpeedY = y;}
+
+    /**
+     * Fish swim, so they are redrawn every frame
+     * @return true
+     */
+    bool IsAnimated() const override { return true; }
+    void SetSpeed(double x, double y);
+
+    /**
+     * Get the fish speed in the X direction
+     * @return Speed in pixels per second
+     */
+    double GetSpeedX() const { return GetKinematics()->SpeedX(GetSlot()); }
+
+    /**
+     * Get the fish speed in the Y direction
+     * @return Speed in pixels per second
+     */
+    double GetSpeedY() const { return GetKinematics()->SpeedY(GetSlot()); }
 
 };
 
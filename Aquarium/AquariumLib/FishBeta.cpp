@@ -6,6 +6,7 @@
 #include "pch.h"
 #include "FishBeta.h"
 #include "Aquarium.h"
+#include "SpeciesRegistry.h"
 #include <string>
 
 using namespace std;
@@ -13,29 +14,35 @@ using namespace std;
 /// Fish filename
 const wstring FishBetaImageName = L"images/beta.png";
 
+/// Tag beta fish are saved with
+const string FishBetaType = "beta";
+
+/**
+ * Get the beta fish species. The registry never moves a species,
+ * so it is only looked up the first time.
+ * @return The registered species
+ */
+static const Species &FishBetaSpecies()
+{
+    static const Species &species = SpeciesRegistry::Instance().Get(FishBetaType);
+    return species;
+}
+
 /**
  * Constructor
  * @param aquarium Aquarium this fish is a member of
  */
- FishBeta::FishBeta(Aquarium *aquarium) : Fish(aquarium, FishBetaImageName)
+ FishBeta::FishBeta(Aquarium *aquarium) : Fish(aquarium, FishBetaSpecies())
 {
     SetSpeed(20, -10);
 }
 
 /**
- * Save this fish to an XML node
- * @param node The parent node we are going to be a child of
- * @return
+ * Register the beta fish species
+ * @param registry Registry to add the species to
  */
-wxXmlNode* FishBeta::XmlSave(wxXmlNode* node)
+void FishBeta::Register(SpeciesRegistry &registry)
 {
-    auto itemNode = Fish::XmlSave(node);
-
-    itemNode->AddAttribute(L"type", L"beta");
-
-    return itemNode;
+    registry.Add(FishBetaType, FishBetaImageName, L"&Beta Fish", L"Add a Beta Fish", Species::Menu::Fish,
+            [](Aquarium *aquarium) -> Item* { return aquarium->Create<FishBeta>(); });
 }
-
-
-
-
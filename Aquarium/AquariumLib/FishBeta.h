@@ -10,6 +10,8 @@
 
 #include "Fish.h"
 
+class SpeciesRegistry;
+
 class FishBeta : public Fish {
 private:
 
@@ -25,8 +27,10 @@ public:
 
     FishBeta(Aquarium* aquarium);
 
-    wxXmlNode* XmlSave(wxXmlNode* node) override;
+    static void Register(SpeciesRegistry &registry);
 
 };
 
+AQUARIUM_POOL_RELEASABLE(FishBeta);
+
 #endif //AQUARIUM_FISHBETA_H
@@ -0,0 +1,34 @@
+/**
+ * @file HitMask.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "HitMask.h"
+
+/**
+ * Constructor
+ *
+ * A pixel is opaque if wxImage::IsTransparent says it is not
+ * transparent, so the mask agrees with testing the image directly.
+ *
+ * @param image The image to build the mask from
+ */
+HitMask::HitMask(const wxImage &image) :
+        mWidth(image.GetWidth()), mHeight(image.GetHeight())
+{
+    mStride = (mWidth + 63) / 64;
+    mBits.resize((size_t)mStride * mHeight, 0);
+
+    for (int y = 0; y < mHeight; y++)
+    {
+        auto row = &mBits[(size_t)y * mStride];
+        for (int x = 0; x < mWidth; x++)
+        {
+            if (!image.IsTransparent(x, y))
+            {
+                row[x >> 6] |= uint64_t(1) << (x & 63);
+            }
+        }
+    }
+}
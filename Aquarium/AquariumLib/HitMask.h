@@ -0,0 +1,67 @@
+/**
+ * @file HitMask.h
+ * @author joeyv
+ *
+ * One bit per pixel record of which pixels of an image are opaque.
+ */
+
+#ifndef AQUARIUM_HITMASK_H
+#define AQUARIUM_HITMASK_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * One bit per pixel record of which pixels of an image are opaque.
+ *
+ * Each row is packed into 64 bit words so testing a pixel
+ * is a single word lookup and a shift.
+ */
+class HitMask {
+private:
+    /// Width of the mask in pixels
+    int mWidth = 0;
+
+    /// Height of the mask in pixels
+    int mHeight = 0;
+
+    /// Number of 64 bit words in each row
+    int mStride = 0;
+
+    /// The packed opacity bits, row by row
+    std::vector<uint64_t> mBits;
+
+public:
+    HitMask() = default;
+    explicit HitMask(const wxImage &image);
+
+    /**
+     * Test a pixel of the mask
+     * @param x X location relative to the top left of the image
+     * @param y Y location relative to the top left of the image
+     * @return true if the pixel is inside the image and opaque
+     */
+    bool Test(int x, int y) const
+    {
+        if (x < 0 || y < 0 || x >= mWidth || y >= mHeight)
+        {
+            return false;
+        }
+
+        return (mBits[y * mStride + (x >> 6)] >> (x & 63)) & 1;
+    }
+
+    /**
+     * Get the width of the mask
+     * @return Width in pixels
+     */
+    int GetWidth() const { return mWidth; }
+
+    /**
+     * Get the height of the mask
+     * @return Height in pixels
+     */
+    int GetHeight() const { return mHeight; }
+};
+
+#endif //AQUARIUM_HITMASK_H
@@ -0,0 +1,274 @@
+/**
+ * @file ImageCache.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "ImageCache.h"
+#include "MappedFile.h"
+#include <wx/file.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+/// First bytes of every cache file
+const char ImageCacheMagic[8] = {'A', 'Q', 'U', 'A', 'I', 'M', 'G', '\0'};
+
+/// Cache file version, change it whenever the layout changes
+const uint32_t ImageCacheVersion = 2;
+
+/// Extension of cache files
+const wchar_t *ImageCacheExtension = L".img";
+
+/// Extension of a cache file while it is being written
+const wchar_t *ImageCacheTemporaryExtension = L".part";
+
+/**
+ * The start of a cache file.
+ *
+ * The image filename follows, as wchar_t, then the RGB bytes
+ * of the image and, if it has alpha, one alpha byte per pixel.
+ */
+struct ImageCacheHeader {
+    char magic[8];          ///< ImageCacheMagic
+    uint32_t version;       ///< ImageCacheVersion
+    uint32_t width;         ///< Image width in pixels
+    uint32_t height;        ///< Image height in pixels
+    uint32_t alpha;         ///< 1 if the image has alpha
+    int64_t modified;       ///< Modification time of the image file
+    uint64_t hash;          ///< Hash of the contents of the image file
+    uint32_t nameLength;    ///< Length of the image filename in characters
+    uint32_t mask;          ///< 1 if the image has a mask colour
+    uint8_t maskRed;        ///< Mask colour red
+    uint8_t maskGreen;      ///< Mask colour green
+    uint8_t maskBlue;       ///< Mask colour blue
+    uint8_t maskReserved;   ///< Always 0
+    uint32_t reserved;      ///< Always 0
+};
+
+/**
+ * Compute the 64 bit FNV-1a hash of some bytes
+ * @param data First byte
+ * @param size Number of bytes
+ * @return Hash
+ */
+static uint64_t Hash(const void *data, size_t size)
+{
+    auto bytes = (const uint8_t *)data;
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+
+    return hash;
+}
+
+/**
+ * Compute the hash of the contents of a file
+ * @param filename File to read
+ * @param hash Set to the hash
+ * @return true if the file could be read
+ */
+static bool HashFile(const wstring &filename, uint64_t &hash)
+{
+    wxFile file;
+    if (!file.Open(filename, wxFile::read))
+    {
+        return false;
+    }
+
+    auto length = file.Length();
+    if (length == wxInvalidOffset)
+    {
+        return false;
+    }
+
+    vector<char> contents((size_t)length);
+    if (file.Read(contents.data(), contents.size()) != length)
+    {
+        return false;
+    }
+
+    hash = Hash(contents.data(), contents.size());
+    return true;
+}
+
+/**
+ * Load an image, from the cache if it is there and up to date
+ * @param directory Cache directory, created if it does not exist
+ * @param filename The image file
+ * @return The image, which is not Ok if it could not be loaded
+ */
+wxImage ImageCache::Load(const wstring &directory, const wstring &filename)
+{
+    int64_t modified = wxFileModificationTime(filename);
+    if (modified == -1)
+    {
+        return wxImage(filename, wxBITMAP_TYPE_ANY);
+    }
+
+    wxImage image;
+    auto path = GetCachePath(directory, filename);
+    if (Read(path, filename, modified, nullptr, image))
+    {
+        return image;
+    }
+
+    // The image file was modified since the cache file was
+    // written, or copied with a new time. Only decode it
+    // again if its contents have changed.
+    uint64_t hash;
+    if (!HashFile(filename, hash))
+    {
+        return wxImage(filename, wxBITMAP_TYPE_ANY);
+    }
+
+    if (!Read(path, filename, modified, &hash, image))
+    {
+        image = wxImage(filename, wxBITMAP_TYPE_ANY);
+        if (!image.IsOk())
+        {
+            return image;
+        }
+    }
+
+    Write(directory, path, filename, modified, hash, image);
+    return image;
+}
+
+/**
+ * Get the cache file for an image file
+ * @param directory Cache directory
+ * @param filename The image file
+ * @return Path of the cache file
+ */
+wstring ImageCache::GetCachePath(const wstring &directory, const wstring &filename)
+{
+    auto hash = Hash(filename.data(), filename.size() * sizeof(wchar_t));
+
+    wchar_t name[17];
+    swprintf(name, 17, L"%016llx", (unsigned long long)hash);
+    return directory + L"/" + name + ImageCacheExtension;
+}
+
+/**
+ * Read an image from a cache file
+ * @param path The cache file
+ * @param filename The image file it must be for
+ * @param modified Modification time the image file has now
+ * @param hash If not null, accept a cache file with this content
+ * hash instead of the same modification time
+ * @param image Set to the image if the cache file is usable
+ * @return true if the cache file is usable
+ */
+bool ImageCache::Read(const wstring &path, const wstring &filename,
+        int64_t modified, const uint64_t *hash, wxImage &image)
+{
+    MappedFile file(path);
+    auto data = file.GetData();
+    auto size = file.GetSize();
+
+    ImageCacheHeader header;
+    if (size < sizeof(header))
+    {
+        return false;
+    }
+
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, ImageCacheMagic, sizeof(ImageCacheMagic)) != 0 ||
+            header.version != ImageCacheVersion ||
+            header.nameLength != filename.size() ||
+            (hash != nullptr ? header.hash != *hash : header.modified != modified))
+    {
+        return false;
+    }
+
+    size_t nameBytes = filename.size() * sizeof(wchar_t);
+    size_t pixels = (size_t)header.width * header.height;
+    size_t alpha = header.alpha != 0 ? pixels : 0;
+    if (size != sizeof(header) + nameBytes + pixels * 3 + alpha ||
+            memcmp(data + sizeof(header), filename.data(), nameBytes) != 0)
+    {
+        return false;
+    }
+
+    auto rgb = data + sizeof(header) + nameBytes;
+    image = wxImage(header.width, header.height, false);
+    memcpy(image.GetData(), rgb, pixels * 3);
+    if (alpha != 0)
+    {
+        image.InitAlpha();
+        memcpy(image.GetAlpha(), rgb + pixels * 3, alpha);
+    }
+
+    if (header.mask != 0)
+    {
+        image.SetMaskColour(header.maskRed, header.maskGreen, header.maskBlue);
+    }
+
+    return true;
+}
+
+/**
+ * Write an image to a cache file, replacing any that is there.
+ * Failure to write the cache is not an error, it is only slower.
+ * @param directory Cache directory, created if it does not exist
+ * @param path The cache file
+ * @param filename The image file the image was decoded from
+ * @param modified Modification time of the image file
+ * @param hash Hash of the contents of the image file
+ * @param image The decoded image
+ */
+void ImageCache::Write(const wstring &directory, const wstring &path, const wstring &filename,
+        int64_t modified, uint64_t hash, const wxImage &image)
+{
+    if (!wxFileName::DirExists(directory))
+    {
+        wxFileName::Mkdir(directory, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+    }
+
+    ImageCacheHeader header = {};
+    memcpy(header.magic, ImageCacheMagic, sizeof(ImageCacheMagic));
+    header.version = ImageCacheVersion;
+    header.width = (uint32_t)image.GetWidth();
+    header.height = (uint32_t)image.GetHeight();
+    header.alpha = image.HasAlpha() ? 1 : 0;
+    header.modified = modified;
+    header.hash = hash;
+    header.nameLength = (uint32_t)filename.size();
+    if (image.HasMask())
+    {
+        header.mask = 1;
+        header.maskRed = image.GetMaskRed();
+        header.maskGreen = image.GetMaskGreen();
+        header.maskBlue = image.GetMaskBlue();
+    }
+
+    size_t nameBytes = filename.size() * sizeof(wchar_t);
+    size_t pixels = (size_t)header.width * header.height;
+
+    // Write to a temporary file, so another copy of the
+    // program never maps a cache file that is half written
+    auto temporary = path + ImageCacheTemporaryExtension;
+    bool written = false;
+    {
+        wxFile file;
+        if (file.Open(temporary, wxFile::write))
+        {
+            written = file.Write(&header, sizeof(header)) == sizeof(header) &&
+                    file.Write(filename.data(), nameBytes) == nameBytes &&
+                    file.Write(image.GetData(), pixels * 3) == pixels * 3 &&
+                    (header.alpha == 0 || file.Write(image.GetAlpha(), pixels) == pixels) &&
+                    file.Close();
+        }
+    }
+
+    if (!written || !wxRenameFile(temporary, path, true))
+    {
+        wxRemoveFile(temporary);
+    }
+}
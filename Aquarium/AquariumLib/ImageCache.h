@@ -0,0 +1,45 @@
+/**
+ * @file ImageCache.h
+ * @author joeyv
+ *
+ * Directory of decoded images, so image files are not decoded on every run.
+ */
+
+#ifndef AQUARIUM_IMAGECACHE_H
+#define AQUARIUM_IMAGECACHE_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Directory of decoded images, so image files are not decoded on every run.
+ *
+ * Each image file has one cache file holding its pixels,
+ * alpha and mask colour exactly as wxImage stores them, so
+ * loading one is a copy out of a memory-mapped file. A cache
+ * file is used if the image file has the same modification
+ * time, or failing that the same contents, as when the cache
+ * file was written.
+ * Otherwise the image is decoded and the cache file replaced.
+ *
+ * Cache files are in the byte order of the machine that wrote
+ * them and are only meant to be read on that machine.
+ * Every function can be called on any thread.
+ */
+class ImageCache {
+public:
+    /// Default constructor (disabled)
+    ImageCache() = delete;
+
+    static wxImage Load(const std::wstring &directory, const std::wstring &filename);
+
+    static std::wstring GetCachePath(const std::wstring &directory, const std::wstring &filename);
+
+private:
+    static bool Read(const std::wstring &path, const std::wstring &filename,
+            int64_t modified, const uint64_t *hash, wxImage &image);
+    static void Write(const std::wstring &directory, const std::wstring &path, const std::wstring &filename,
+            int64_t modified, uint64_t hash, const wxImage &image);
+};
+
+#endif //AQUARIUM_IMAGECACHE_H
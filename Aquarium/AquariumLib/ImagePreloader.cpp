@@ -0,0 +1,173 @@
+/**
+ * @file ImagePreloader.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "ImagePreloader.h"
+#include "ThreadPool.h"
+#include "ImageCache.h"
+#include <cstring>
+
+using namespace std;
+
+/**
+ * Destructor, waits for any images still being decoded
+ */
+ImagePreloader::~ImagePreloader()
+{
+    Wait();
+}
+
+/**
+ * Get the one image preloader for this process
+ * @return Reference to the image preloader
+ */
+ImagePreloader &ImagePreloader::Instance()
+{
+    static ImagePreloader preloader;
+    return preloader;
+}
+
+/**
+ * Start decoding images in the background.
+ *
+ * Only the first call does anything. Call this from the
+ * thread that will call Get, after the image handlers
+ * have been added.
+ *
+ * @param filenames Image files to decode
+ * @param cacheDirectory ImageCache directory to use, empty to always decode the files
+ */
+void ImagePreloader::Start(const vector<wstring> &filenames, const wstring &cacheDirectory)
+{
+    if (IsStarted() || filenames.empty())
+    {
+        return;
+    }
+
+    // The futures are all in place before the thread starts,
+    // so the map never changes while images are decoded
+    vector<promise<DecodedImage>> promises(filenames.size());
+    for (size_t i = 0; i < filenames.size(); i++)
+    {
+        mImages[filenames[i]].decoded = promises[i].get_future();
+    }
+
+    mThread = thread([filenames, cacheDirectory, promises = move(promises)]() mutable {
+        ThreadPool pool(max(1, (int)thread::hardware_concurrency()));
+        pool.ParallelFor(0, (int)filenames.size(), 1, [&](int begin, int end) {
+            for (int i = begin; i < end; i++)
+            {
+                // The wxImage is gone before the pixels are handed over
+                DecodedImage decoded;
+                {
+                    auto image = cacheDirectory.empty() ?
+                            wxImage(filenames[i], wxBITMAP_TYPE_ANY) :
+                            ImageCache::Load(cacheDirectory, filenames[i]);
+                    decoded = Decode(image);
+                }
+
+                promises[i].set_value(move(decoded));
+            }
+        });
+    });
+}
+
+/**
+ * Copy the pixels out of an image
+ * @param image The image
+ * @return The pixels, with a width of 0 if the image is not Ok
+ */
+ImagePreloader::DecodedImage ImagePreloader::Decode(const wxImage &image)
+{
+    DecodedImage decoded;
+    if (!image.IsOk())
+    {
+        return decoded;
+    }
+
+    decoded.width = image.GetWidth();
+    decoded.height = image.GetHeight();
+    size_t pixels = (size_t)decoded.width * decoded.height;
+    decoded.rgb.assign(image.GetData(), image.GetData() + pixels * 3);
+    if (image.HasAlpha())
+    {
+        decoded.alpha.assign(image.GetAlpha(), image.GetAlpha() + pixels);
+    }
+
+    decoded.mask = image.HasMask();
+    if (decoded.mask)
+    {
+        decoded.maskRed = image.GetMaskRed();
+        decoded.maskGreen = image.GetMaskGreen();
+        decoded.maskBlue = image.GetMaskBlue();
+    }
+
+    return decoded;
+}
+
+/**
+ * Make an image from decoded pixels
+ * @param decoded The pixels
+ * @return The image, which is not Ok if the width is 0
+ */
+wxImage ImagePreloader::MakeImage(const DecodedImage &decoded)
+{
+    if (decoded.width == 0)
+    {
+        return wxImage();
+    }
+
+    wxImage image(decoded.width, decoded.height, false);
+    memcpy(image.GetData(), decoded.rgb.data(), decoded.rgb.size());
+    if (!decoded.alpha.empty())
+    {
+        image.InitAlpha();
+        memcpy(image.GetAlpha(), decoded.alpha.data(), decoded.alpha.size());
+    }
+
+    if (decoded.mask)
+    {
+        image.SetMaskColour(decoded.maskRed, decoded.maskGreen, decoded.maskBlue);
+    }
+
+    return image;
+}
+
+/**
+ * Wait until every image passed to Start is decoded
+ */
+void ImagePreloader::Wait()
+{
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+}
+
+/**
+ * Get a decoded image.
+ *
+ * Images that were not passed to Start are read
+ * from the disk each time they are asked for.
+ *
+ * @param filename The image file
+ * @return The image, which is not Ok if it could not be loaded
+ */
+wxImage ImagePreloader::Get(const wstring &filename)
+{
+    auto found = mImages.find(filename);
+    if (found != mImages.end())
+    {
+        auto &entry = found->second;
+        if (entry.decoded.valid())
+        {
+            entry.image = MakeImage(entry.decoded.get());
+        }
+
+        return entry.image;
+    }
+
+    return wxImage(filename, wxBITMAP_TYPE_ANY);
+}
@@ -0,0 +1,93 @@
+/**
+ * @file ImagePreloader.h
+ * @author joeyv
+ *
+ * Decodes the images the aquarium uses before they are needed.
+ */
+
+#ifndef AQUARIUM_IMAGEPRELOADER_H
+#define AQUARIUM_IMAGEPRELOADER_H
+
+#include <future>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Decodes the images the aquarium uses before they are needed.
+ *
+ * Start decodes a list of image files on a thread pool while
+ * the program does other work, such as building its windows.
+ * Get then returns a decoded image without reading the disk,
+ * waiting only if that one image is not decoded yet. Given an
+ * ImageCache directory, images decoded on an earlier run are
+ * read from it instead of being decoded again. Images
+ * stay decoded for the life of the program, so the first item
+ * of each species and every new aquarium find them in memory.
+ */
+class ImagePreloader {
+private:
+    /**
+     * An image decoded on a pool thread, as plain pixels.
+     *
+     * wxImage counts its references without atomics, so the
+     * pool threads hand over these buffers and only the thread
+     * that calls Get ever holds a wxImage made from them.
+     */
+    struct DecodedImage {
+        int width = 0;                      ///< Width in pixels, 0 if the image could not be loaded
+        int height = 0;                     ///< Height in pixels
+        std::vector<unsigned char> rgb;     ///< RGB bytes, row by row
+        std::vector<unsigned char> alpha;   ///< Alpha byte per pixel, empty if the image has none
+        bool mask = false;                  ///< True if the image has a mask colour
+        unsigned char maskRed = 0;          ///< Mask colour red
+        unsigned char maskGreen = 0;        ///< Mask colour green
+        unsigned char maskBlue = 0;         ///< Mask colour blue
+    };
+
+    /// A preloaded image
+    struct Entry {
+        /// The decoded pixels, until Get first takes them
+        std::future<DecodedImage> decoded;
+
+        /// The image made from the pixels once Get has taken them
+        wxImage image;
+    };
+
+    /// Images being decoded or decoded, keyed by filename
+    std::unordered_map<std::wstring, Entry> mImages;
+
+    /// Thread that decodes the images
+    std::thread mThread;
+
+    ImagePreloader() = default;
+
+    static DecodedImage Decode(const wxImage &image);
+    static wxImage MakeImage(const DecodedImage &decoded);
+
+public:
+    virtual ~ImagePreloader();
+
+    /// Copy constructor (disabled)
+    ImagePreloader(const ImagePreloader &) = delete;
+
+    /// Assignment operator
+    void operator=(const ImagePreloader &) = delete;
+
+    static ImagePreloader &Instance();
+
+    void Start(const std::vector<std::wstring> &filenames, const std::wstring &cacheDirectory = std::wstring());
+
+    void Wait();
+
+    wxImage Get(const std::wstring &filename);
+
+    /**
+     * Has Start been called?
+     * @return true if images are being or have been preloaded
+     */
+    bool IsStarted() const { return !mImages.empty(); }
+};
+
+#endif //AQUARIUM_IMAGEPRELOADER_H
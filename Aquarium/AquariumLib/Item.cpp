@@ -6,6 +6,7 @@
 #include "pch.h"
 #include "Item.h"
 #include "Aquarium.h"
+#include "SpriteCache.h"
 
 using namespace std;
 
@@ -14,19 +15,23 @@ using namespace std;
  * @param aquarium The aquarium this item is a member of
  * @param filename The name of the file to display for this item
  */
-Item::Item(Aquarium *aquarium, const std::wstring &filename) : mAquarium(aquarium)
+Item::Item(Aquarium *aquarium, const std::wstring &filename) :
+        mAquarium(aquarium), mKinematics(&aquarium->GetKinematics())
 {
-    mItemImage = make_unique<wxImage>(filename, wxBITMAP_TYPE_ANY);
-    mItemBitmap = make_unique<wxBitmap>(*mItemImage);
-
+    mSprite = aquarium->Retain(SpriteCache::Instance().Get(filename));
+    mSlot = mKinematics->Allocate(this, mSprite->GetWidth() / 2.0);
 }
 
 /**
- * Destructor
+ * Constructor for an item of a registered species
+ * @param aquarium The aquarium this item is a member of
+ * @param species The species of this item
  */
-Item::~Item()
+Item::Item(Aquarium *aquarium, const Species &species) :
+        mAquarium(aquarium), mKinematics(&aquarium->GetKinematics()), mSpecies(&species)
 {
-
+    mSprite = aquarium->Retain(species);
+    mSlot = mKinematics->Allocate(this, mSprite->GetWidth() / 2.0);
 }
 
 /**
@@ -34,13 +39,11 @@ Item::~Item()
  * @param item Item we are computing the distance to
  * @return Distance in pixels
 */
-double Item::DistanceTo(shared_ptr<Item> item)
+double Item::DistanceTo(const Item *item) const
 {
     auto dx = item->GetX() - GetX();
     auto dy = item->GetY() - GetY();
-    double d = sqrt(dx * dx + dy * dy);
     return sqrt(dx * dx + dy * dy);
-
 }
 
 /**
@@ -51,8 +54,8 @@ double Item::DistanceTo(shared_ptr<Item> item)
 */
 bool Item::HitTest(int x, int y)
 {
-    double wid = mItemBitmap->GetWidth();
-    double hit = mItemBitmap->GetHeight();
+    double wid = mSprite->GetWidth();
+    double hit = mSprite->GetHeight();
 
     // Make x and y relative to the top-left corner of the bitmap image
     // Subtracting the center makes x, y relative to the image center
@@ -68,69 +71,62 @@ bool Item::HitTest(int x, int y)
     }
 
     // Test to see if x, y are in the drawn part of the image
-    // If the location is transparent, we are not in the drawn
-    // part of the image
-    return !mItemImage->IsTransparent((int)testX, (int)testY);
-
-
+    // using the opacity mask for the way we are facing
+    return mSprite->GetMask(GetMirror()).Test((int)testX, (int)testY);
 }
 
 /**
- * Draw this fish
- * @param dc Device contect to draw on
+ * Set the item location
+ * @param x X location in pixels
+ * @param y Y location in pixels
  */
-void Item::Draw(wxDC* dc)
+void Item::SetLocation(double x, double y)
 {
-    double wid = mItemBitmap->GetWidth();
-    double hit = mItemBitmap->GetHeight();
-    dc->DrawBitmap(*mItemBitmap,
-            int(GetX() - wid / 2),
-            int(GetY() - hit / 2));
-
+    auto oldX = mKinematics->DrawX(mSlot);
+    auto oldY = mKinematics->DrawY(mSlot);
+    mKinematics->Place(mSlot, x, y);
+    mAquarium->OnItemMoved(this, oldX, oldY);
 }
 
 /**
- * Save this item to an XML node
- * @param node The parent node we are going to be a child of
- * @return wxXmlNode that we saved the item into
+ * Set the mirror status
+ * @param m New mirror flag
  */
-wxXmlNode *Item::XmlSave(wxXmlNode *node)
+void Item::SetMirror(bool m)
 {
-    auto itemNode = new wxXmlNode(wxXML_ELEMENT_NODE, L"item");
-    node->AddChild(itemNode);
-
-    itemNode->AddAttribute(L"x", wxString::FromDouble(mX));
-    itemNode->AddAttribute(L"y", wxString::FromDouble(mY));
-
-    return itemNode;
+    if (m != GetMirror())
+    {
+        mKinematics->Mirror(mSlot) = m;
+        mAquarium->OnItemChanged(this);
+    }
 }
 
 /**
- * Load the attributes for an item node.
- *
- * This is the  base class version that loads the attributes
- * common to all items. Override this to load custom attributes
- * for specific items.
- *
- * @param node The Xml node we are loading the item from
+ * Draw this fish
+ * @param dc Device contect to draw on
  */
-void Item::XmlLoad(wxXmlNode *node)
+void Item::Draw(wxDC* dc)
 {
-    node->GetAttribute(L"x", L"0").ToDouble(&mX);
-    node->GetAttribute(L"y", L"0").ToDouble(&mY);
+    Draw(dc, mKinematics->DrawX(mSlot), mKinematics->DrawY(mSlot), GetMirror());
 }
 
 /**
- * Set the mirror status
- * @param m New mirror flag
+ * Draw this item at a given location and facing.
+ *
+ * This only uses the item image, so it is safe to call
+ * while another thread is moving the item.
+ *
+ * @param dc Device context to draw on
+ * @param x X location of the item center
+ * @param y Y location of the item center
+ * @param mirror True to draw the item facing the other way
  */
-void Item::SetMirror(bool m) {
-    if(m != mMirror)
-    {
-        // This code only executes if the mirror state changes
-        mMirror = m;
-        if (mMirror){mItemBitmap = make_unique<wxBitmap>(mItemImage->Mirror());}
-        else{mItemBitmap = make_unique<wxBitmap>(*mItemImage);}
-
-    }
+void Item::Draw(wxDC* dc, double x, double y, bool mirror)
+{
+    const wxBitmap &bitmap = mSprite->GetBitmap(mirror);
+    double wid = bitmap.GetWidth();
+    double hit = bitmap.GetHeight();
+    dc->DrawBitmap(bitmap,
+            int(x - wid / 2),
+            int(y - hit / 2));
 }
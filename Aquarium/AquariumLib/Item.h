@@ -8,32 +8,67 @@
 #ifndef AQUARIUM_ITEM_H
 #define AQUARIUM_ITEM_H
 
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+
+#include "Sprite.h"
+#include "Species.h"
+#include "Kinematics.h"
+#include "ItemHandle.h"
+
 class Aquarium;
 
 /**
  * Base class for any item in our aquarium.
+ *
+ * The location and motion of the item are not stored in
+ * the item, but in a slot of the aquarium Kinematics arrays.
+ *
+ * Items are created with Aquarium::Create, which allocates
+ * them from a pool, and live until the aquarium is cleared,
+ * when their destructors are run. A type that owns nothing
+ * its destructor frees can specialize IsPoolReleasable so
+ * that clearing skips its destructor.
  */
 class Item {
 private:
+    friend class Kinematics;
+    friend class Aquarium;
+
     /// The aquarium this item is contained in
     Aquarium   *mAquarium;
 
-    // Item location in the aquarium
-    double  mX = 0;     ///< X location for the center of the item
-    double  mY = 0;     ///< Y location for the center of the item
-    bool mMirror = false;   ///< True mirrors the item image
+    /// The arrays our location and motion are stored in
+    Kinematics *mKinematics;
+
+    /// Our slot in mKinematics, maintained by Kinematics
+    int mSlot;
+
+    /// Drawing order in the aquarium, larger is in front
+    int64_t mZOrder = 0;
 
-    /// The underlying fish image
-    std::unique_ptr<wxImage> mItemImage;
+    /// The image shared by every item of this type,
+    /// kept loaded by the aquarium
+    Sprite *mSprite;
 
-    /// The bitmap we can display for this fish
-    std::unique_ptr<wxBitmap> mItemBitmap;
+    /// Handle the aquarium gave this item
+    ItemHandle mHandle;
+
+    /// The registered species of this item, if any
+    const Species *mSpecies = nullptr;
 
 protected:
     Item(Aquarium *aquarium, const std::wstring &filename);
+    Item(Aquarium *aquarium, const Species &species);
 
 public:
-    virtual ~Item();
+    /**
+     * Destructor. Run by the aquarium when it is cleared,
+     * unless IsPoolReleasable is true for the item type.
+     */
+    virtual ~Item() = default;
 
     /// Default constructor (disabled)
     Item() = delete;
@@ -48,20 +83,27 @@ public:
      * The X location of the item
      * @return X location in pixels
      */
-    double GetX() const { return mX; }
+    double GetX() const { return mKinematics->X(mSlot); }
 
     /**
      * The Y location of the item
      * @return Y location in pixels
      */
-    double GetY() const { return mY; }
+    double GetY() const { return mKinematics->Y(mSlot); }
+
+    void SetLocation(double x, double y);
+
+    /**
+     * Get the drawing order of this item
+     * @return Order key, items with larger keys are in front
+     */
+    int64_t GetZOrder() const { return mZOrder; }
 
     /**
-     * Set the item location
-     * @param x X location in pixels
-     * @param y Y location in pixels
+     * Set the drawing order of this item. Used by DrawOrder.
+     * @param z New order key
      */
-    void SetLocation(double x, double y) { mX = x; mY = y; }
+    void SetZOrder(int64_t z) { mZOrder = z; }
 
     /**
     * Test this item
@@ -72,10 +114,21 @@ public:
     */
     bool HitTest(int x, int y);
 
-    double DistanceTo(std::shared_ptr<Item> item);
+    double DistanceTo(const Item *item) const;
     void Draw(wxDC* dc);
-    virtual wxXmlNode *XmlSave(wxXmlNode *node);
-    virtual void XmlLoad(wxXmlNode *node);
+    void Draw(wxDC* dc, double x, double y, bool mirror);
+    /**
+     * Get the registered species of this item
+     * @return Species, or null if the item is not of a registered species
+     */
+    const Species *GetSpecies() const { return mSpecies; }
+
+    /**
+     * Get the type tag that identifies this kind of item in saved files
+     * @return Type tag, empty if the item is not of a registered species
+     */
+    std::string_view GetType() const { return mSpecies != nullptr ? mSpecies->GetType() : std::string_view(); }
+
 
     /**
      * Handle updates for animation
@@ -83,6 +136,15 @@ public:
      */
     virtual void Update(double elapsed) {}
 
+    /**
+     * Does this item move on its own?
+     *
+     * Items that do not are drawn into the aquarium
+     * static layer instead of every frame.
+     * @return true if Update can change this item
+     */
+    virtual bool IsAnimated() const { return false; }
+
     /**
      * Get the pointer to the Aquarium object
      * @return Pointer to Aquarium object
@@ -92,10 +154,76 @@ public:
     void SetMirror(bool m);
 
     /**
-     * Get the length of the Fish
-     * @return Length of fish
+     * Get the mirror status
+     * @return True if the item is drawn mirrored
+     */
+    bool GetMirror() const { return mKinematics->Mirror(mSlot) != 0; }
+
+    /**
+     * Get the arrays this item's location and motion are stored in
+     * @return Pointer to the Kinematics object
      */
-    double GetLength(){return mItemBitmap->GetWidth();}
+    Kinematics *GetKinematics() const { return mKinematics; }
+
+    /**
+     * Get the slot of this item in the Kinematics arrays.
+     * The slot can change when other items are added or destroyed.
+     * @return Slot index
+     */
+    int GetSlot() const { return mSlot; }
+
+    /**
+     * Get the sprite this item displays
+     * @return Pointer to the shared sprite
+     */
+    Sprite *GetSprite() const { return mSprite; }
+
+    /**
+     * Get a handle that refers to this item
+     * @return Handle, which Aquarium::Get turns back into this item
+     */
+    ItemHandle GetHandle() const { return mHandle; }
+
+    /**
+     * Get the length of the item
+     * @return Length of the item in pixels
+     */
+    double GetLength() const { return mSprite->GetWidth(); }
+
+    /**
+     * Get the width of the item image
+     * @return Width in pixels
+     */
+    int GetWidth() const { return mSprite->GetWidth(); }
+
+    /**
+     * Get the height of the item image
+     * @return Height in pixels
+     */
+    int GetHeight() const { return mSprite->GetHeight(); }
 };
 
+/**
+ * Says whether an aquarium may free items of type T without
+ * running their destructors, which lets it clear them in time
+ * proportional to the number of pool slabs rather than items.
+ *
+ * False unless specialized. Specialize it to true only for a
+ * type whose members, and whose bases' members, own nothing
+ * that a destructor frees. A specialization applies to that
+ * exact type, so subclasses do not inherit it.
+ * @tparam T Item type
+ */
+template <class T>
+struct IsPoolReleasable : std::false_type {};
+
+/**
+ * Mark an item type as IsPoolReleasable. Use it after the
+ * class, at namespace scope, only when the rule above holds.
+ * @param T Item type
+ */
+#define AQUARIUM_POOL_RELEASABLE(T) \
+    template <> \
+    struct IsPoolReleasable<T> : std::true_type {}
+
 #endif //AQUARIUM_ITEM_H
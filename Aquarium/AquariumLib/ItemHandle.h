@@ -0,0 +1,50 @@
+/**
+ * @file ItemHandle.h
+ * @author joeyv
+ *
+ * Reference to an item that can tell when the item is gone.
+ */
+
+#ifndef AQUARIUM_ITEMHANDLE_H
+#define AQUARIUM_ITEMHANDLE_H
+
+#include <cstdint>
+
+/**
+ * Reference to an item that can tell when the item is gone.
+ *
+ * A handle is an index into the handle table of the aquarium
+ * that created the item and the generation that entry had.
+ * Generations are never reused, so Aquarium::Get returns null
+ * for a handle once the aquarium is cleared, loaded or its
+ * items swapped away, rather than some other item.
+ */
+struct ItemHandle {
+    uint32_t index = 0;         ///< Entry in the aquarium handle table
+    uint32_t generation = 0;    ///< Generation of the entry, 0 for no item
+
+    /**
+     * Does this handle refer to no item at all?
+     * @return true for a default constructed handle
+     */
+    bool IsNull() const { return generation == 0; }
+
+    /**
+     * Compare handles
+     * @param other Other handle
+     * @return true if both refer to the same item
+     */
+    bool operator==(const ItemHandle &other) const
+    {
+        return index == other.index && generation == other.generation;
+    }
+
+    /**
+     * Compare handles
+     * @param other Other handle
+     * @return true if the handles refer to different items
+     */
+    bool operator!=(const ItemHandle &other) const { return !(*this == other); }
+};
+
+#endif //AQUARIUM_ITEMHANDLE_H
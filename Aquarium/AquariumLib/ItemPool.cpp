@@ -0,0 +1,83 @@
+/**
+ * @file ItemPool.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "ItemPool.h"
+#include <atomic>
+
+using namespace std;
+
+/// Approximate size of each slab in bytes
+const size_t SlabSize = 64 * 1024;
+
+/**
+ * Constructor
+ * @param size Size of each item in bytes
+ * @param destroy Function Release runs on each item before
+ * dropping it, or null to drop items without destroying them
+ */
+ItemPool::ItemPool(size_t size, void (*destroy)(void *item)) : mDestroy(destroy)
+{
+    const size_t align = alignof(max_align_t);
+    mBlockSize = (max(size, (size_t)1) + align - 1) / align * align;
+    mSlabBlocks = max(SlabSize / mBlockSize, (size_t)1);
+}
+
+/**
+ * Destructor
+ */
+ItemPool::~ItemPool()
+{
+    Release();
+}
+
+/**
+ * Get the memory for a new item
+ * @return Memory for one item, aligned for any type
+ */
+void *ItemPool::Allocate()
+{
+    if (mSlabs.empty() || mUsed == mSlabBlocks)
+    {
+        mSlabs.push_back(unique_ptr<char[]>(new char[mSlabBlocks * mBlockSize]));
+        mUsed = 0;
+    }
+
+    return mSlabs.back().get() + mBlockSize * mUsed++;
+}
+
+/**
+ * Free the memory of every item at once. Without a destroy
+ * function this takes time proportional to the number of
+ * slabs, with one it also runs the function on every item.
+ */
+void ItemPool::Release()
+{
+    if (mDestroy != nullptr)
+    {
+        // Every slab but the last is full
+        for (size_t s = 0; s < mSlabs.size(); s++)
+        {
+            auto count = s + 1 < mSlabs.size() ? mSlabBlocks : mUsed;
+            for (size_t b = 0; b < count; b++)
+            {
+                mDestroy(mSlabs[s].get() + mBlockSize * b);
+            }
+        }
+    }
+
+    mSlabs.clear();
+    mUsed = 0;
+}
+
+/**
+ * Get an index no other item type has
+ * @return Next unused type index
+ */
+int ItemPool::NewTypeId()
+{
+    static atomic<int> next {0};
+    return next++;
+}
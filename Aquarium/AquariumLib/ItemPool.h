@@ -0,0 +1,100 @@
+/**
+ * @file ItemPool.h
+ * @author joeyv
+ *
+ * Slab allocator for the items of one type.
+ */
+
+#ifndef AQUARIUM_ITEMPOOL_H
+#define AQUARIUM_ITEMPOOL_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * Slab allocator for the items of one type.
+ *
+ * Memory is handed out from slabs of many items each, so
+ * creating an item is usually a pointer bump rather than a
+ * heap allocation, and items of a type are next to each
+ * other in memory. Memory is never given back one item at a
+ * time. Release drops every slab at once. If the pool was
+ * given a destroy function it is first run on every item,
+ * otherwise the items are dropped without being destroyed.
+ */
+class ItemPool {
+private:
+    /// Size of each item, rounded up to keep items aligned
+    size_t mBlockSize;
+
+    /// Number of items in each slab
+    size_t mSlabBlocks;
+
+    /// The slabs items are allocated from
+    std::vector<std::unique_ptr<char[]>> mSlabs;
+
+    /// Number of items allocated from the last slab
+    size_t mUsed = 0;
+
+    /// Destroys one item, or null if items are dropped
+    /// without being destroyed
+    void (*mDestroy)(void *item);
+
+    static int NewTypeId();
+
+public:
+    explicit ItemPool(size_t size, void (*destroy)(void *item) = nullptr);
+    ~ItemPool();
+
+    /// Default constructor (disabled)
+    ItemPool() = delete;
+
+    /// Copy constructor (disabled)
+    ItemPool(const ItemPool &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const ItemPool &) = delete;
+
+    void *Allocate();
+    void Release();
+
+    /**
+     * Get the number of slabs allocated
+     * @return Slab count
+     */
+    size_t GetSlabCount() const { return mSlabs.size(); }
+
+    /**
+     * Get the number of items in each slab
+     * @return Items per slab
+     */
+    size_t GetSlabBlocks() const { return mSlabBlocks; }
+
+    /**
+     * Destroy function that runs the destructor of T
+     * @tparam T Item type
+     * @param item Memory holding an item of type T
+     */
+    template <class T>
+    static void Destroy(void *item)
+    {
+        static_cast<T*>(item)->~T();
+    }
+
+    /**
+     * Get the pool index for a type of item. Every
+     * type gets a different small index the first
+     * time this is called for it.
+     * @tparam T Item type
+     * @return Index of the pool for items of type T
+     */
+    template <class T>
+    static int TypeId()
+    {
+        static const int id = NewTypeId();
+        return id;
+    }
+};
+
+#endif //AQUARIUM_ITEMPOOL_H
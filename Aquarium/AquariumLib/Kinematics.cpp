@@ -0,0 +1,340 @@
+/**
+ * @file Kinematics.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "Kinematics.h"
+#include "Item.h"
+#include "SpatialGrid.h"
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Constructor
+ *
+ * Uses the fastest integration loop this processor supports.
+ */
+Kinematics::Kinematics()
+{
+    SetKernel(GetBestKernel());
+}
+
+/**
+ * Choose the integration loop to use
+ * @param kernel Kernel to use
+ * @return false if this processor does not support the kernel
+ */
+bool Kinematics::SetKernel(Kernel kernel)
+{
+    if (!IsSupported(kernel))
+    {
+        return false;
+    }
+
+    mKernel = kernel;
+    mIntegrate = GetIntegrateFunction(kernel);
+    return true;
+}
+
+/**
+ * Make room for a number of slots, so allocating
+ * that many does not grow the arrays one at a time
+ * @param count Total number of slots to make room for
+ */
+void Kinematics::Reserve(int count)
+{
+    mX.reserve(count);
+    mY.reserve(count);
+    mPrevX.reserve(count);
+    mPrevY.reserve(count);
+    mGridX.reserve(count);
+    mGridY.reserve(count);
+    mSpeedX.reserve(count);
+    mSpeedY.reserve(count);
+    mHalfLength.reserve(count);
+    mMirror.reserve(count);
+    mOwner.reserve(count);
+}
+
+/**
+ * Allocate a slot for a new item. The slot is not active.
+ * @param owner The item that owns the slot
+ * @param halfLength Half the length of the item image
+ * @return The new slot
+ */
+int Kinematics::Allocate(Item *owner, double halfLength)
+{
+    mX.push_back(0);
+    mY.push_back(0);
+    mPrevX.push_back(0);
+    mPrevY.push_back(0);
+    mGridX.push_back(0);
+    mGridY.push_back(0);
+    mSpeedX.push_back(0);
+    mSpeedY.push_back(0);
+    mHalfLength.push_back(halfLength);
+    mMirror.push_back(0);
+    mOwner.push_back(owner);
+
+    return (int)mOwner.size() - 1;
+}
+
+/**
+ * Exchange two slots, telling their owners where they went
+ * @param a First slot
+ * @param b Second slot
+ */
+void Kinematics::Swap(int a, int b)
+{
+    if (a == b)
+    {
+        return;
+    }
+
+    swap(mX[a], mX[b]);
+    swap(mY[a], mY[b]);
+    swap(mPrevX[a], mPrevX[b]);
+    swap(mPrevY[a], mPrevY[b]);
+    swap(mGridX[a], mGridX[b]);
+    swap(mGridY[a], mGridY[b]);
+    swap(mSpeedX[a], mSpeedX[b]);
+    swap(mSpeedY[a], mSpeedY[b]);
+    swap(mHalfLength[a], mHalfLength[b]);
+    swap(mMirror[a], mMirror[b]);
+    swap(mOwner[a], mOwner[b]);
+
+    mOwner[a]->mSlot = a;
+    mOwner[b]->mSlot = b;
+}
+
+/**
+ * Make a slot active when its item is added to the aquarium
+ *
+ * Animated slots are moved in front of the static ones, so
+ * only they are integrated. A static slot keeps its speed
+ * but does not move.
+ *
+ * @param slot Slot to activate
+ * @param animated True if the item is animated
+ */
+void Kinematics::Activate(int slot, bool animated)
+{
+    if (slot >= mActive)
+    {
+        Swap(slot, mActive);
+        slot = mActive;
+        mActive++;
+    }
+
+    if (animated && slot >= mAnimated)
+    {
+        Swap(slot, mAnimated);
+        slot = mAnimated;
+        mAnimated++;
+    }
+
+    // The item starts out drawn where it is
+    mPrevX[slot] = mX[slot];
+    mPrevY[slot] = mY[slot];
+}
+
+/**
+ * Activate every slot at once, when all of the items are
+ * added together and no slot is active yet.
+ *
+ * Activating the slots one at a time in the order they were
+ * allocated swaps every animated slot that comes after a
+ * static one. This swaps at most once for each static slot
+ * instead. Within each partition the slots are not kept in
+ * the order they were allocated.
+ */
+void Kinematics::ActivateAll()
+{
+    int front = 0;
+    int back = GetCount() - 1;
+    while (true)
+    {
+        while (front <= back && mOwner[front]->IsAnimated())
+        {
+            front++;
+        }
+
+        while (front < back && !mOwner[back]->IsAnimated())
+        {
+            back--;
+        }
+
+        if (front >= back)
+        {
+            break;
+        }
+
+        Swap(front, back);
+        front++;
+        back--;
+    }
+
+    mActive = GetCount();
+    mAnimated = front;
+
+    // The items start out drawn where they are
+    mPrevX = mX;
+    mPrevY = mY;
+}
+
+/**
+ * Remove every slot when the aquarium is cleared. The
+ * owners are not told, as they are being freed too.
+ */
+void Kinematics::Clear()
+{
+    mX.clear();
+    mY.clear();
+    mPrevX.clear();
+    mPrevY.clear();
+    mGridX.clear();
+    mGridY.clear();
+    mSpeedX.clear();
+    mSpeedY.clear();
+    mHalfLength.clear();
+    mMirror.clear();
+    mOwner.clear();
+    mActive = 0;
+    mAnimated = 0;
+}
+
+/**
+ * Point the owner of every slot at these arrays and an
+ * aquarium, after the arrays have moved to that aquarium
+ * @param aquarium Aquarium the arrays now belong to
+ */
+void Kinematics::Rebind(Aquarium *aquarium)
+{
+    for (auto owner : mOwner)
+    {
+        owner->mKinematics = this;
+        owner->mAquarium = aquarium;
+    }
+}
+
+/**
+ * Move an item to a location without any motion in
+ * between, so it is drawn there right away
+ * @param slot Item slot
+ * @param x New X location
+ * @param y New Y location
+ */
+void Kinematics::Place(int slot, double x, double y)
+{
+    mX[slot] = x;
+    mY[slot] = y;
+    mPrevX[slot] = x;
+    mPrevY[slot] = y;
+}
+
+/**
+ * Set the speed of an item
+ * @param slot Item slot
+ * @param x Speed in the X direction in pixels per second
+ * @param y Speed in the Y direction in pixels per second
+ */
+void Kinematics::SetSpeed(int slot, double x, double y)
+{
+    mSpeedX[slot] = x;
+    mSpeedY[slot] = y;
+}
+
+/**
+ * Get pointers to the arrays for an integration kernel
+ * @return Array pointers
+ */
+KinematicsArrays Kinematics::GetArrays()
+{
+    KinematicsArrays arrays;
+    arrays.x = mX.data();
+    arrays.y = mY.data();
+    arrays.prevX = mPrevX.data();
+    arrays.prevY = mPrevY.data();
+    arrays.speedX = mSpeedX.data();
+    arrays.speedY = mSpeedY.data();
+    arrays.halfLength = mHalfLength.data();
+    arrays.mirror = mMirror.data();
+    return arrays;
+}
+
+/**
+ * Advance every animated item by one time step.
+ *
+ * Items move at their speed and turn around when they
+ * reach the walls of the aquarium, mirroring when they
+ * turn in X. Every kernel gives the same result as
+ * Fish::Update does for one fish.
+ *
+ * @param elapsed Time step in seconds
+ * @param width Width of the aquarium in pixels
+ * @param height Height of the aquarium in pixels
+ */
+void Kinematics::Integrate(double elapsed, double width, double height)
+{
+    mIntegrate(GetArrays(), 0, mAnimated, elapsed, width, height);
+}
+
+/**
+ * Advance a range of animated slots by one time step.
+ *
+ * Slots do not affect each other, so ranges can be
+ * advanced at the same time on different threads.
+ *
+ * @param start First slot to advance
+ * @param end One past the last slot to advance
+ * @param elapsed Time step in seconds
+ * @param width Width of the aquarium in pixels
+ * @param height Height of the aquarium in pixels
+ */
+void Kinematics::Integrate(int start, int end, double elapsed, double width, double height)
+{
+    mIntegrate(GetArrays(), start, end, elapsed, width, height);
+}
+
+/**
+ * Insert the item in a slot into the spatial grid
+ * @param slot Item slot
+ * @param grid Grid to insert into
+ */
+void Kinematics::PlaceInGrid(int slot, SpatialGrid &grid)
+{
+    grid.Insert(mOwner[slot]);
+    mGridX[slot] = mX[slot];
+    mGridY[slot] = mY[slot];
+}
+
+/**
+ * Tell the spatial grid the item in a slot has moved
+ * @param slot Item slot
+ * @param grid Grid the item is in
+ */
+void Kinematics::MoveInGrid(int slot, SpatialGrid &grid)
+{
+    grid.Move(mOwner[slot], mGridX[slot], mGridY[slot]);
+    mGridX[slot] = mX[slot];
+    mGridY[slot] = mY[slot];
+}
+
+/**
+ * Bring the spatial grid up to date with every animated
+ * item that has moved since it was last told. Static items
+ * only move through MoveInGrid.
+ * @param grid Grid the animated items are in
+ */
+void Kinematics::SyncGrid(SpatialGrid &grid)
+{
+    for (int i = 0; i < mAnimated; i++)
+    {
+        if (mX[i] != mGridX[i] || mY[i] != mGridY[i])
+        {
+            MoveInGrid(i, grid);
+        }
+    }
+}
@@ -0,0 +1,190 @@
+/**
+ * @file Kinematics.h
+ * @author joeyv
+ *
+ * Location and motion of every item, stored as parallel arrays.
+ */
+
+#ifndef AQUARIUM_KINEMATICS_H
+#define AQUARIUM_KINEMATICS_H
+
+#include <cstdint>
+#include <vector>
+
+class Item;
+class Aquarium;
+class SpatialGrid;
+
+/**
+ * Pointers to the arrays an integration kernel works on
+ */
+struct KinematicsArrays {
+    double *x;                  ///< X locations
+    double *y;                  ///< Y locations
+    double *prevX;              ///< X locations before the step
+    double *prevY;              ///< Y locations before the step
+    double *speedX;             ///< X speeds
+    double *speedY;             ///< Y speeds
+    const double *halfLength;   ///< Half lengths of the item images
+    uint8_t *mirror;            ///< Mirror flags
+};
+
+/**
+ * Location and motion of every item, stored as parallel arrays.
+ *
+ * Each item owns one slot, allocated when the item is constructed.
+ * Slots are freed all at once when the aquarium is cleared, as
+ * items are. The Item object reads and writes
+ * its location through its slot. Slots of items that are in the
+ * aquarium are kept packed at the front of the arrays, animated
+ * items first and then static ones, so animating the aquarium is
+ * one loop over contiguous memory with no virtual calls that never
+ * touches a static item. Slots move when items are activated, and
+ * the owning item is told its new slot.
+ */
+class Kinematics {
+public:
+    /// Implementations of the integration loop
+    enum class Kernel {Scalar, SSE2, AVX2};
+
+    /// An integration loop over slots start to end - 1
+    typedef void (*IntegrateFunction)(const KinematicsArrays &arrays, int start, int end,
+            double elapsed, double width, double height);
+
+private:
+    std::vector<double> mX;          ///< X location of the item center
+    std::vector<double> mY;          ///< Y location of the item center
+    std::vector<double> mPrevX;      ///< X location before the last step
+    std::vector<double> mPrevY;      ///< Y location before the last step
+    std::vector<double> mGridX;      ///< X location the spatial grid knows
+    std::vector<double> mGridY;      ///< Y location the spatial grid knows
+    std::vector<double> mSpeedX;     ///< X speed in pixels per second
+    std::vector<double> mSpeedY;     ///< Y speed in pixels per second
+    std::vector<double> mHalfLength; ///< Half the length of the item image
+    std::vector<uint8_t> mMirror;    ///< Nonzero if the item is mirrored
+    std::vector<Item*> mOwner;       ///< The item that owns each slot
+
+    /// Number of slots at the front that are in the aquarium
+    int mActive = 0;
+
+    /// Number of slots at the front that are animated,
+    /// the rest of the active slots are static
+    int mAnimated = 0;
+
+    /// Fraction of the last step at which items are drawn,
+    /// from 0 at the previous location to 1 at the current one
+    double mAlpha = 1;
+
+    /// The integration loop we are using
+    Kernel mKernel;
+
+    /// Function that implements mKernel
+    IntegrateFunction mIntegrate;
+
+    void Swap(int a, int b);
+    KinematicsArrays GetArrays();
+
+    static IntegrateFunction GetIntegrateFunction(Kernel kernel);
+
+public:
+    Kinematics();
+
+    static bool IsSupported(Kernel kernel);
+    static Kernel GetBestKernel();
+    bool SetKernel(Kernel kernel);
+
+    /**
+     * Get the integration loop in use
+     * @return Kernel used by Integrate
+     */
+    Kernel GetKernel() const { return mKernel; }
+
+    void Reserve(int count);
+    int Allocate(Item *owner, double halfLength);
+    void Activate(int slot, bool animated);
+    void ActivateAll();
+    void Clear();
+    void Rebind(Aquarium *aquarium);
+
+    void Place(int slot, double x, double y);
+    void SetSpeed(int slot, double x, double y);
+    void Integrate(double elapsed, double width, double height);
+    void Integrate(int start, int end, double elapsed, double width, double height);
+
+    void PlaceInGrid(int slot, SpatialGrid &grid);
+    void MoveInGrid(int slot, SpatialGrid &grid);
+    void SyncGrid(SpatialGrid &grid);
+
+    /**
+     * Is a slot in the aquarium?
+     * @param slot Slot to test
+     * @return true if the slot is animated with the aquarium
+     */
+    bool IsActive(int slot) const { return slot < mActive; }
+
+    /**
+     * Get the number of slots in the aquarium
+     * @return Active slot count, these are slots 0 to count - 1
+     */
+    int GetActiveCount() const { return mActive; }
+
+    /**
+     * Is a slot in the aquarium and animated?
+     * @param slot Slot to test
+     * @return true if Integrate moves the slot
+     */
+    bool IsAnimated(int slot) const { return slot < mAnimated; }
+
+    /**
+     * Get the number of animated slots in the aquarium
+     * @return Animated slot count, these are slots 0 to count - 1
+     */
+    int GetAnimatedCount() const { return mAnimated; }
+
+    /**
+     * Get the number of allocated slots
+     * @return Slot count
+     */
+    int GetCount() const { return (int)mOwner.size(); }
+
+    /** X location @param slot Item slot @return Reference to the location */
+    double &X(int slot) { return mX[slot]; }
+
+    /** Y location @param slot Item slot @return Reference to the location */
+    double &Y(int slot) { return mY[slot]; }
+
+    /** X location before the last step @param slot Item slot @return Location */
+    double PrevX(int slot) const { return mPrevX[slot]; }
+
+    /** Y location before the last step @param slot Item slot @return Location */
+    double PrevY(int slot) const { return mPrevY[slot]; }
+
+    /** X speed @param slot Item slot @return Reference to the speed */
+    double &SpeedX(int slot) { return mSpeedX[slot]; }
+
+    /** Y speed @param slot Item slot @return Reference to the speed */
+    double &SpeedY(int slot) { return mSpeedY[slot]; }
+
+    /** X location the item is drawn at @param slot Item slot @return Location */
+    double DrawX(int slot) const { return mPrevX[slot] + (mX[slot] - mPrevX[slot]) * mAlpha; }
+
+    /** Y location the item is drawn at @param slot Item slot @return Location */
+    double DrawY(int slot) const { return mPrevY[slot] + (mY[slot] - mPrevY[slot]) * mAlpha; }
+
+    /**
+     * Set how far through the last step items are drawn
+     * @param alpha Fraction from 0 to 1
+     */
+    void SetAlpha(double alpha) { mAlpha = alpha; }
+
+    /** Half length of the item @param slot Item slot @return Half length in pixels */
+    double HalfLength(int slot) const { return mHalfLength[slot]; }
+
+    /** Mirror flag @param slot Item slot @return Reference to the flag */
+    uint8_t &Mirror(int slot) { return mMirror[slot]; }
+
+    /** Owning item @param slot Item slot @return Pointer to the item */
+    Item *Owner(int slot) const { return mOwner[slot]; }
+};
+
+#endif //AQUARIUM_KINEMATICS_H
@@ -0,0 +1,318 @@
+/**
+ * @file KinematicsKernels.cpp
+ * @author joeyv
+ *
+ * The integration loops for Kinematics.
+ *
+ * There is a plain loop that works everywhere, and SSE2 and
+ * AVX2 loops that advance two or four items at a time on x86
+ * processors. The vector loops are compiled for their
+ * instruction set with function attributes, so the library
+ * still runs on processors without them, and the best one
+ * is chosen when the program runs.
+ *
+ * Every loop must give exactly the same result as Fish::Update,
+ * so they compute the same expressions in the same order. The
+ * library is built with floating point contraction into FMA
+ * instructions turned off, so the compiler cannot change that.
+ */
+
+#include "pch.h"
+#include "Kinematics.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define AQUARIUM_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(AQUARIUM_X86) && defined(__GNUC__)
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+/// Distance from the walls fish turn around at, in pixels
+const double WallMargin = 10;
+
+/**
+ * Integration loop that advances one item at a time
+ * @param arrays The arrays to update
+ * @param start First slot to update
+ * @param end One past the last slot to update
+ * @param elapsed Time step in seconds
+ * @param width Width of the aquarium in pixels
+ * @param height Height of the aquarium in pixels
+ */
+static void IntegrateScalar(const KinematicsArrays &arrays, int start, int end,
+        double elapsed, double width, double height)
+{
+    auto x = arrays.x;
+    auto y = arrays.y;
+    auto speedX = arrays.speedX;
+    auto speedY = arrays.speedY;
+    auto halfLength = arrays.halfLength;
+    auto mirror = arrays.mirror;
+
+    for (int i = start; i < end; i++)
+    {
+        arrays.prevX[i] = x[i];
+        arrays.prevY[i] = y[i];
+        x[i] += speedX[i] * elapsed;
+        y[i] += speedY[i] * elapsed;
+
+        if (speedX[i] > 0 && x[i] >= (width - WallMargin - halfLength[i]))
+        {
+            speedX[i] = -speedX[i];
+            mirror[i] = 1;
+        }
+        else if (speedX[i] < 0 && x[i] <= (WallMargin + halfLength[i]))
+        {
+            speedX[i] = -speedX[i];
+            mirror[i] = 0;
+        }
+
+        if (speedY[i] > 0 && y[i] >= (height - WallMargin - halfLength[i]))
+        {
+            speedY[i] = -speedY[i];
+        }
+        else if (speedY[i] < 0 && y[i] <= (WallMargin + halfLength[i]))
+        {
+            speedY[i] = -speedY[i];
+        }
+    }
+}
+
+#ifdef AQUARIUM_X86
+
+/**
+ * Set the mirror flags of the items that turned in X
+ * @param mirror Mirror flags of the first item in the group
+ * @param right Bit per item, set if it turned at the right wall
+ * @param left Bit per item, set if it turned at the left wall
+ * @param lanes Number of items in the group
+ */
+static inline void SetMirrors(uint8_t *mirror, int right, int left, int lanes)
+{
+    for (int lane = 0; lane < lanes; lane++)
+    {
+        if (right & (1 << lane))
+        {
+            mirror[lane] = 1;
+        }
+        else if (left & (1 << lane))
+        {
+            mirror[lane] = 0;
+        }
+    }
+}
+
+/**
+ * Integration loop that advances two items at a time with SSE2
+ * @param arrays The arrays to update
+ * @param start First slot to update
+ * @param end One past the last slot to update
+ * @param elapsed Time step in seconds
+ * @param width Width of the aquarium in pixels
+ * @param height Height of the aquarium in pixels
+ */
+TARGET_SSE2 static void IntegrateSSE2(const KinematicsArrays &arrays, int start, int end,
+        double elapsed, double width, double height)
+{
+    const __m128d dt = _mm_set1_pd(elapsed);
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d sign = _mm_set1_pd(-0.0);
+    const __m128d low = _mm_set1_pd(WallMargin);
+    const __m128d highX = _mm_set1_pd(width - WallMargin);
+    const __m128d highY = _mm_set1_pd(height - WallMargin);
+
+    int i = start;
+    for ( ; i + 2 <= end; i += 2)
+    {
+        __m128d half = _mm_loadu_pd(arrays.halfLength + i);
+        __m128d lowLimit = _mm_add_pd(low, half);
+
+        // X, which also sets the mirror flags
+        __m128d x = _mm_loadu_pd(arrays.x + i);
+        __m128d speed = _mm_loadu_pd(arrays.speedX + i);
+        _mm_storeu_pd(arrays.prevX + i, x);
+        x = _mm_add_pd(x, _mm_mul_pd(speed, dt));
+        _mm_storeu_pd(arrays.x + i, x);
+
+        __m128d right = _mm_and_pd(_mm_cmpgt_pd(speed, zero),
+                _mm_cmpge_pd(x, _mm_sub_pd(highX, half)));
+        __m128d left = _mm_and_pd(_mm_cmplt_pd(speed, zero),
+                _mm_cmple_pd(x, lowLimit));
+        __m128d turn = _mm_or_pd(right, left);
+        _mm_storeu_pd(arrays.speedX + i, _mm_xor_pd(speed, _mm_and_pd(turn, sign)));
+
+        if (_mm_movemask_pd(turn) != 0)
+        {
+            SetMirrors(arrays.mirror + i, _mm_movemask_pd(right), _mm_movemask_pd(left), 2);
+        }
+
+        // Y
+        __m128d y = _mm_loadu_pd(arrays.y + i);
+        speed = _mm_loadu_pd(arrays.speedY + i);
+        _mm_storeu_pd(arrays.prevY + i, y);
+        y = _mm_add_pd(y, _mm_mul_pd(speed, dt));
+        _mm_storeu_pd(arrays.y + i, y);
+
+        turn = _mm_or_pd(
+                _mm_and_pd(_mm_cmpgt_pd(speed, zero), _mm_cmpge_pd(y, _mm_sub_pd(highY, half))),
+                _mm_and_pd(_mm_cmplt_pd(speed, zero), _mm_cmple_pd(y, lowLimit)));
+        _mm_storeu_pd(arrays.speedY + i, _mm_xor_pd(speed, _mm_and_pd(turn, sign)));
+    }
+
+    IntegrateScalar(arrays, i, end, elapsed, width, height);
+}
+
+/**
+ * Integration loop that advances four items at a time with AVX2
+ * @param arrays The arrays to update
+ * @param start First slot to update
+ * @param end One past the last slot to update
+ * @param elapsed Time step in seconds
+ * @param width Width of the aquarium in pixels
+ * @param height Height of the aquarium in pixels
+ */
+TARGET_AVX2 static void IntegrateAVX2(const KinematicsArrays &arrays, int start, int end,
+        double elapsed, double width, double height)
+{
+    const __m256d dt = _mm256_set1_pd(elapsed);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d low = _mm256_set1_pd(WallMargin);
+    const __m256d highX = _mm256_set1_pd(width - WallMargin);
+    const __m256d highY = _mm256_set1_pd(height - WallMargin);
+
+    int i = start;
+    for ( ; i + 4 <= end; i += 4)
+    {
+        __m256d half = _mm256_loadu_pd(arrays.halfLength + i);
+        __m256d lowLimit = _mm256_add_pd(low, half);
+
+        // X, which also sets the mirror flags
+        __m256d x = _mm256_loadu_pd(arrays.x + i);
+        __m256d speed = _mm256_loadu_pd(arrays.speedX + i);
+        _mm256_storeu_pd(arrays.prevX + i, x);
+        x = _mm256_add_pd(x, _mm256_mul_pd(speed, dt));
+        _mm256_storeu_pd(arrays.x + i, x);
+
+        __m256d right = _mm256_and_pd(_mm256_cmp_pd(speed, zero, _CMP_GT_OQ),
+                _mm256_cmp_pd(x, _mm256_sub_pd(highX, half), _CMP_GE_OQ));
+        __m256d left = _mm256_and_pd(_mm256_cmp_pd(speed, zero, _CMP_LT_OQ),
+                _mm256_cmp_pd(x, lowLimit, _CMP_LE_OQ));
+        __m256d turn = _mm256_or_pd(right, left);
+        _mm256_storeu_pd(arrays.speedX + i, _mm256_xor_pd(speed, _mm256_and_pd(turn, sign)));
+
+        if (_mm256_movemask_pd(turn) != 0)
+        {
+            SetMirrors(arrays.mirror + i, _mm256_movemask_pd(right), _mm256_movemask_pd(left), 4);
+        }
+
+        // Y
+        __m256d y = _mm256_loadu_pd(arrays.y + i);
+        speed = _mm256_loadu_pd(arrays.speedY + i);
+        _mm256_storeu_pd(arrays.prevY + i, y);
+        y = _mm256_add_pd(y, _mm256_mul_pd(speed, dt));
+        _mm256_storeu_pd(arrays.y + i, y);
+
+        turn = _mm256_or_pd(
+                _mm256_and_pd(_mm256_cmp_pd(speed, zero, _CMP_GT_OQ),
+                        _mm256_cmp_pd(y, _mm256_sub_pd(highY, half), _CMP_GE_OQ)),
+                _mm256_and_pd(_mm256_cmp_pd(speed, zero, _CMP_LT_OQ),
+                        _mm256_cmp_pd(y, lowLimit, _CMP_LE_OQ)));
+        _mm256_storeu_pd(arrays.speedY + i, _mm256_xor_pd(speed, _mm256_and_pd(turn, sign)));
+    }
+
+    IntegrateScalar(arrays, i, end, elapsed, width, height);
+}
+
+#endif
+
+/**
+ * Determine if this processor can run a kernel
+ * @param kernel Kernel to test
+ * @return true if the kernel can be used
+ */
+bool Kinematics::IsSupported(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case Kernel::Scalar:
+        return true;
+
+#if defined(AQUARIUM_X86) && defined(__GNUC__)
+    case Kernel::SSE2:
+        return __builtin_cpu_supports("sse2");
+
+    case Kernel::AVX2:
+        return __builtin_cpu_supports("avx2");
+#elif defined(AQUARIUM_X86) && defined(_MSC_VER)
+    case Kernel::SSE2:
+    {
+        int info[4];
+        __cpuid(info, 1);
+        return (info[3] & (1 << 26)) != 0;
+    }
+
+    case Kernel::AVX2:
+    {
+        int info[4];
+        __cpuid(info, 1);
+        bool osSaves = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+        __cpuidex(info, 7, 0);
+        return osSaves && (info[1] & (1 << 5)) != 0;
+    }
+#endif
+
+    default:
+        return false;
+    }
+}
+
+/**
+ * Get the fastest kernel this processor can run
+ * @return Kernel to use
+ */
+Kinematics::Kernel Kinematics::GetBestKernel()
+{
+    if (IsSupported(Kernel::AVX2))
+    {
+        return Kernel::AVX2;
+    }
+
+    if (IsSupported(Kernel::SSE2))
+    {
+        return Kernel::SSE2;
+    }
+
+    return Kernel::Scalar;
+}
+
+/**
+ * Get the function that implements a kernel
+ * @param kernel Kernel we want
+ * @return Function for the kernel
+ */
+Kinematics::IntegrateFunction Kinematics::GetIntegrateFunction(Kernel kernel)
+{
+    switch (kernel)
+    {
+#ifdef AQUARIUM_X86
+    case Kernel::SSE2:
+        return IntegrateSSE2;
+
+    case Kernel::AVX2:
+        return IntegrateAVX2;
+#endif
+
+    default:
+        return IntegrateScalar;
+    }
+}
@@ -6,6 +6,7 @@
 #include "MainFrame.h"
 #include "AquariumView.h"
 #include "ids.h"
+#include "SpeciesRegistry.h"
 
 /**
 * Initialize the MainFrame window.
@@ -45,12 +46,18 @@ void MainFrame::Initialize()
 
     fileMenu->Append(wxID_EXIT, "E&xit\tAlt-X", "Quit this program");
     helpMenu->Append(wxID_ABOUT, "&About\tF1", "Show about dialog");
-    fishMenu->Append(IDM_ADDFISHBETA, L"&Beta Fish", L"Add a Beta Fish");
-    fishMenu->Append(IDM_ADDFISHNEMO, L"&Sparty Fish", L"Add a Sparty Fish");
-    fishMenu->Append(IDM_ADDFISHANGEL, L"&Stinky Fish", L"Add a Stinky Fish");
-    decorMenu->Append(IDM_ADDDECORCASTLE, L"&Castle", L"Add a Castle");
+
+    auto &registry = SpeciesRegistry::Instance();
+    for (int i = 0; i < registry.GetCount(); i++)
+    {
+        auto &species = registry.GetSpecies(i);
+        auto menu = species.GetMenu() == Species::Menu::Fish ? fishMenu : decorMenu;
+        menu->Append(IDM_ADDSPECIES + i, species.GetName(), species.GetHelp());
+    }
+
     fileMenu->Append(wxID_SAVEAS, "Save &As...\tCtrl-S", L"Save aquarium as...");
     fileMenu->Append(wxID_OPEN, "Open &File...\tCtrl-F", L"Open aquarium file...");
+    fileMenu->Append(IDM_FILECANCEL, "&Cancel Load or Save\tEsc", L"Stop loading or saving a file");
 
     SetMenuBar( menuBar );
 
@@ -0,0 +1,139 @@
+/**
+ * @file MappedFile.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+
+/**
+ * Constructor
+ * @param filename File to map
+ */
+MappedFile::MappedFile(const wxString &filename)
+{
+    auto file = CreateFileW(filename.wc_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return;
+    }
+
+    mFile = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        return;
+    }
+
+    mSize = (size_t)size.QuadPart;
+    mOpen = true;
+
+    // A file mapping cannot be created for an empty file
+    if (mSize == 0)
+    {
+        return;
+    }
+
+    mMapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mMapping != nullptr)
+    {
+        mData = (const char *)MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+    }
+
+    if (mData == nullptr)
+    {
+        mOpen = false;
+        mSize = 0;
+    }
+}
+
+/**
+ * Destructor
+ */
+MappedFile::~MappedFile()
+{
+    if (mData != nullptr)
+    {
+        UnmapViewOfFile(mData);
+    }
+
+    if (mMapping != nullptr)
+    {
+        CloseHandle(mMapping);
+    }
+
+    if (mFile != nullptr)
+    {
+        CloseHandle(mFile);
+    }
+}
+
+#else
+
+/**
+ * Constructor
+ * @param filename File to map
+ */
+MappedFile::MappedFile(const wxString &filename)
+{
+    int fd = open(filename.fn_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) == 0)
+    {
+        mSize = (size_t)status.st_size;
+        mOpen = true;
+
+        // An empty file cannot be mapped
+        if (mSize > 0)
+        {
+            auto data = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                // The file is read front to back
+                madvise(data, mSize, MADV_SEQUENTIAL);
+                mData = (const char *)data;
+            }
+            else
+            {
+                mOpen = false;
+                mSize = 0;
+            }
+        }
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    close(fd);
+}
+
+/**
+ * Destructor
+ */
+MappedFile::~MappedFile()
+{
+    if (mData != nullptr)
+    {
+        munmap((void *)mData, mSize);
+    }
+}
+
+#endif
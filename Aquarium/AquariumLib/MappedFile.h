@@ -0,0 +1,71 @@
+/**
+ * @file MappedFile.h
+ * @author joeyv
+ *
+ * A whole file mapped read-only into memory.
+ */
+
+#ifndef AQUARIUM_MAPPEDFILE_H
+#define AQUARIUM_MAPPEDFILE_H
+
+#include <cstddef>
+
+/**
+ * A whole file mapped read-only into memory.
+ *
+ * The operating system pages the file in as it is read,
+ * so nothing is copied into our own buffers. The mapping
+ * is released when this object is destroyed.
+ */
+class MappedFile {
+private:
+    /// Start of the mapped file, or null if it is empty or not open
+    const char *mData = nullptr;
+
+    /// Size of the file in bytes
+    size_t mSize = 0;
+
+    /// True if the file was opened
+    bool mOpen = false;
+
+#ifdef _WIN32
+    /// Handle of the open file
+    void *mFile = nullptr;
+
+    /// Handle of the file mapping object
+    void *mMapping = nullptr;
+#endif
+
+public:
+    explicit MappedFile(const wxString &filename);
+    virtual ~MappedFile();
+
+    /// Default constructor (disabled)
+    MappedFile() = delete;
+
+    /// Copy constructor (disabled)
+    MappedFile(const MappedFile &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const MappedFile &) = delete;
+
+    /**
+     * Was the file opened and mapped?
+     * @return true if GetData can be read
+     */
+    bool IsOpen() const { return mOpen; }
+
+    /**
+     * Get the contents of the file
+     * @return Pointer to the first byte, null if the file is empty
+     */
+    const char *GetData() const { return mData; }
+
+    /**
+     * Get the size of the file
+     * @return Size in bytes
+     */
+    size_t GetSize() const { return mSize; }
+};
+
+#endif //AQUARIUM_MAPPEDFILE_H
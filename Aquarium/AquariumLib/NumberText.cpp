@@ -0,0 +1,62 @@
+/**
+ * @file NumberText.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "NumberText.h"
+#include <charconv>
+
+using namespace std;
+
+/// Characters XML allows around an attribute value
+const string_view Whitespace = " \t\r\n";
+
+/**
+ * Format a number as the shortest text that parses back to it
+ * @param value Number to format
+ * @param buffer Buffer to format into
+ * @return The text, which points into buffer
+ */
+string_view NumberText::Format(double value, char (&buffer)[BufferSize])
+{
+    auto result = to_chars(buffer, buffer + BufferSize, value);
+    return string_view(buffer, result.ptr - buffer);
+}
+
+/**
+ * Parse a number.
+ *
+ * Accepts anything older versions wrote with wxString::FromDouble,
+ * and like wxString::ToDouble allows surrounding whitespace and a
+ * leading '+', but nothing else after the number.
+ *
+ * @param text Text to parse
+ * @param value Set to the number if the text is one, unchanged otherwise
+ * @return true if the text is a number
+ */
+bool NumberText::Parse(string_view text, double &value)
+{
+    auto first = text.find_first_not_of(Whitespace);
+    if (first == string_view::npos)
+    {
+        return false;
+    }
+
+    text = text.substr(first, text.find_last_not_of(Whitespace) - first + 1);
+    if (text[0] == '+')
+    {
+        text.remove_prefix(1);
+    }
+
+    double parsed;
+    auto end = text.data() + text.size();
+    auto result = from_chars(text.data(), end, parsed);
+    if (result.ec != errc() || result.ptr != end)
+    {
+        return false;
+    }
+
+    value = parsed;
+    return true;
+}
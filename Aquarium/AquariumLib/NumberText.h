@@ -0,0 +1,33 @@
+/**
+ * @file NumberText.h
+ * @author joeyv
+ *
+ * Conversion of numbers to and from the text in .aqua files.
+ */
+
+#ifndef AQUARIUM_NUMBERTEXT_H
+#define AQUARIUM_NUMBERTEXT_H
+
+#include <string_view>
+
+/**
+ * Conversion of numbers to and from the text in .aqua files.
+ *
+ * Numbers are always written with a '.' decimal point, whatever
+ * the locale, using the fewest digits that read back as exactly
+ * the same double. Neither direction allocates memory.
+ */
+class NumberText {
+public:
+    /// Size of a buffer that can hold any formatted double
+    static const int BufferSize = 32;
+
+    /// Default constructor (disabled)
+    NumberText() = delete;
+
+    static std::string_view Format(double value, char (&buffer)[BufferSize]);
+
+    static bool Parse(std::string_view text, double &value);
+};
+
+#endif //AQUARIUM_NUMBERTEXT_H
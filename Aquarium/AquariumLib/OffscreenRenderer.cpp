@@ -0,0 +1,103 @@
+/**
+ * @file OffscreenRenderer.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "OffscreenRenderer.h"
+#include "Aquarium.h"
+#include <wx/rawbmp.h>
+
+/**
+ * Constructor
+ * @param width Width of the render target in pixels
+ * @param height Height of the render target in pixels
+ */
+OffscreenRenderer::OffscreenRenderer(int width, int height) : mBitmap(width, height, 32)
+{
+}
+
+/**
+ * Draw an aquarium into the render target.
+ *
+ * This publishes a snapshot and draws it the way
+ * AquariumView::OnPaint does, with the whole target
+ * as the one rectangle to draw. Call it on the thread
+ * that would paint, with no SimulationThread running.
+ *
+ * @param aquarium Aquarium to draw
+ */
+void OffscreenRenderer::Render(Aquarium *aquarium)
+{
+    aquarium->UpdateStaticLayer();
+    aquarium->Publish();
+
+    wxMemoryDC dc(mBitmap);
+
+    wxBrush background(*wxWHITE);
+    dc.SetBackground(background);
+    dc.Clear();
+
+    mRects.assign(1, wxRect(0, 0, mBitmap.GetWidth(), mBitmap.GetHeight()));
+    aquarium->DrawSnapshot(&dc, mRects);
+
+    dc.SelectObject(wxNullBitmap);
+}
+
+/**
+ * Read the last rendered frame back as RGBA pixels
+ * @return Buffer of width * height * 4 bytes, row by row
+ */
+const std::vector<unsigned char> &OffscreenRenderer::ReadPixels()
+{
+    int wid = mBitmap.GetWidth();
+    int hit = mBitmap.GetHeight();
+    mPixels.resize((size_t)wid * hit * 4);
+
+    wxAlphaPixelData data(mBitmap);
+    if (!data)
+    {
+        // No direct access on this platform, go
+        // the slow way through an image
+        auto image = mBitmap.ConvertToImage();
+        auto rgb = image.GetData();
+        auto alpha = image.HasAlpha() ? image.GetAlpha() : nullptr;
+        for (size_t i = 0; i < (size_t)wid * hit; i++)
+        {
+            mPixels[i * 4] = rgb[i * 3];
+            mPixels[i * 4 + 1] = rgb[i * 3 + 1];
+            mPixels[i * 4 + 2] = rgb[i * 3 + 2];
+            mPixels[i * 4 + 3] = alpha != nullptr ? alpha[i] : 255;
+        }
+
+        return mPixels;
+    }
+
+    wxAlphaPixelData::Iterator row(data);
+    auto out = mPixels.data();
+    for (int y = 0; y < hit; y++)
+    {
+        wxAlphaPixelData::Iterator p = row;
+        for (int x = 0; x < wid; x++, ++p)
+        {
+            *out++ = p.Red();
+            *out++ = p.Green();
+            *out++ = p.Blue();
+            *out++ = p.Alpha();
+        }
+
+        row.OffsetY(data, 1);
+    }
+
+    return mPixels;
+}
+
+/**
+ * Save the last rendered frame to an image file
+ * @param filename File to save to, the type is chosen by extension
+ * @return true if successful
+ */
+bool OffscreenRenderer::SaveImage(const wxString &filename)
+{
+    return mBitmap.ConvertToImage().SaveFile(filename);
+}
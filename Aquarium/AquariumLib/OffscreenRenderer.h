@@ -0,0 +1,67 @@
+/**
+ * @file OffscreenRenderer.h
+ * @author joeyv
+ *
+ * Draws an aquarium into memory instead of a window.
+ */
+
+#ifndef AQUARIUM_OFFSCREENRENDERER_H
+#define AQUARIUM_OFFSCREENRENDERER_H
+
+#include <vector>
+
+class Aquarium;
+
+/**
+ * Draws an aquarium into memory instead of a window.
+ *
+ * Drawing goes through a wxMemoryDC into a bitmap using
+ * Aquarium::Publish and Aquarium::DrawSnapshot, the same
+ * path the view paints with. The result can be read back
+ * as an RGBA buffer for comparison or saved to an image.
+ *
+ * No window is opened, but the bitmaps and the title font
+ * still need a display on platforms like GTK. Run under
+ * Xvfb where there is none.
+ */
+class OffscreenRenderer {
+private:
+    /// Bitmap we draw into
+    wxBitmap mBitmap;
+
+    /// RGBA pixels read back from the bitmap, row by row
+    std::vector<unsigned char> mPixels;
+
+    /// Rectangles passed to Aquarium::DrawSnapshot
+    std::vector<wxRect> mRects;
+
+public:
+    OffscreenRenderer(int width, int height);
+
+    /// Default constructor (disabled)
+    OffscreenRenderer() = delete;
+
+    /// Copy constructor (disabled)
+    OffscreenRenderer(const OffscreenRenderer &) = delete;
+
+    /// Assignment operator
+    void operator=(const OffscreenRenderer &) = delete;
+
+    void Render(Aquarium *aquarium);
+    const std::vector<unsigned char> &ReadPixels();
+    bool SaveImage(const wxString &filename);
+
+    /**
+     * Get the width of the render target
+     * @return Width in pixels
+     */
+    int GetWidth() const { return mBitmap.GetWidth(); }
+
+    /**
+     * Get the height of the render target
+     * @return Height in pixels
+     */
+    int GetHeight() const { return mBitmap.GetHeight(); }
+};
+
+#endif //AQUARIUM_OFFSCREENRENDERER_H
@@ -0,0 +1,79 @@
+/**
+ * @file SimulationThread.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "SimulationThread.h"
+#include "Aquarium.h"
+#include <chrono>
+
+using namespace std;
+
+/// Time the thread sleeps between advances in seconds. Aquarium
+/// catches up in fixed steps however long the sleep really was.
+const double AdvanceInterval = 1.0 / 120;
+
+/**
+ * Constructor
+ * @param aquarium The aquarium to simulate
+ */
+SimulationThread::SimulationThread(Aquarium *aquarium) : mAquarium(aquarium)
+{
+}
+
+/**
+ * Destructor, stops the thread
+ */
+SimulationThread::~SimulationThread()
+{
+    Stop();
+}
+
+/**
+ * Start simulating
+ */
+void SimulationThread::Start()
+{
+    if (mRunning)
+    {
+        return;
+    }
+
+    mRunning = true;
+    mThread = thread(&SimulationThread::Run, this);
+}
+
+/**
+ * Stop simulating and wait for the thread to finish
+ */
+void SimulationThread::Stop()
+{
+    mRunning = false;
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+}
+
+/**
+ * The simulation loop
+ */
+void SimulationThread::Run()
+{
+    auto last = chrono::steady_clock::now();
+    while (mRunning)
+    {
+        auto now = chrono::steady_clock::now();
+        double elapsed = chrono::duration<double>(now - last).count();
+        last = now;
+
+        {
+            lock_guard<mutex> lock(mAquarium->GetMutex());
+            mAquarium->Advance(elapsed);
+            mAquarium->Publish();
+        }
+
+        this_thread::sleep_until(now + chrono::duration<double>(AdvanceInterval));
+    }
+}
@@ -0,0 +1,61 @@
+/**
+ * @file SimulationThread.h
+ * @author joeyv
+ *
+ * Runs the aquarium simulation on its own thread.
+ */
+
+#ifndef AQUARIUM_SIMULATIONTHREAD_H
+#define AQUARIUM_SIMULATIONTHREAD_H
+
+#include <atomic>
+#include <thread>
+
+class Aquarium;
+
+/**
+ * Runs the aquarium simulation on its own thread.
+ *
+ * The thread advances the aquarium and publishes a snapshot
+ * for drawing about every simulation step. It holds the
+ * aquarium mutex while it does so, and anything else that
+ * uses the aquarium while the thread runs must hold it too.
+ * Drawing from the snapshot needs no lock.
+ */
+class SimulationThread {
+private:
+    /// The aquarium we are simulating
+    Aquarium *mAquarium;
+
+    /// The simulation thread
+    std::thread mThread;
+
+    /// Cleared to ask the thread to stop
+    std::atomic<bool> mRunning {false};
+
+    void Run();
+
+public:
+    explicit SimulationThread(Aquarium *aquarium);
+    virtual ~SimulationThread();
+
+    /// Default constructor (disabled)
+    SimulationThread() = delete;
+
+    /// Copy constructor (disabled)
+    SimulationThread(const SimulationThread &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const SimulationThread &) = delete;
+
+    void Start();
+    void Stop();
+
+    /**
+     * Is the thread running?
+     * @return true if Start has been called without Stop
+     */
+    bool IsRunning() const { return mRunning; }
+};
+
+#endif //AQUARIUM_SIMULATIONTHREAD_H
@@ -0,0 +1,40 @@
+/**
+ * @file SnapshotBuffer.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "SnapshotBuffer.h"
+
+using namespace std;
+
+/// Bit in mMiddle set when it holds a snapshot the reader has not seen
+const int Fresh = 4;
+
+/**
+ * Make the write buffer the latest snapshot and
+ * take another buffer to write the next one into
+ */
+void SnapshotBuffer::Publish()
+{
+    mWrite = mMiddle.exchange(mWrite | Fresh, memory_order_acq_rel) & ~Fresh;
+}
+
+/**
+ * Get the latest published snapshot.
+ *
+ * The snapshot stays valid until the next call. If nothing
+ * has been published since the last call, the same snapshot
+ * is returned again.
+ *
+ * @return The snapshot
+ */
+const std::vector<SnapshotItem> &SnapshotBuffer::Acquire()
+{
+    if (mMiddle.load(memory_order_relaxed) & Fresh)
+    {
+        mRead = mMiddle.exchange(mRead, memory_order_acq_rel) & ~Fresh;
+    }
+
+    return mBuffers[mRead];
+}
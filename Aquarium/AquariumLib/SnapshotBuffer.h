@@ -0,0 +1,70 @@
+/**
+ * @file SnapshotBuffer.h
+ * @author joeyv
+ *
+ * Triple buffer that passes snapshots of the aquarium
+ * from the simulation to the paint handler.
+ */
+
+#ifndef AQUARIUM_SNAPSHOTBUFFER_H
+#define AQUARIUM_SNAPSHOTBUFFER_H
+
+#include <atomic>
+#include <vector>
+
+class Item;
+
+/**
+ * How one item is to be drawn
+ */
+struct SnapshotItem {
+    Item *item;     ///< The item, which supplies the image
+    double x;       ///< X location of the item center
+    double y;       ///< Y location of the item center
+    bool mirror;    ///< True if the item faces the other way
+};
+
+/**
+ * Triple buffer of aquarium snapshots.
+ *
+ * One writer fills the write buffer and publishes it, and
+ * one reader acquires the latest published buffer. They
+ * exchange buffers through a single atomic index, so
+ * neither ever waits for the other. The writer may be any
+ * thread, as long as only one writes at a time.
+ */
+class SnapshotBuffer {
+private:
+    /// The three buffers
+    std::vector<SnapshotItem> mBuffers[3];
+
+    /// Buffer the writer is filling
+    int mWrite = 0;
+
+    /// Buffer waiting to be exchanged, with Fresh set
+    /// if it was published since the reader last took it
+    std::atomic<int> mMiddle {1};
+
+    /// Buffer the reader is drawing from
+    int mRead = 2;
+
+public:
+    SnapshotBuffer() = default;
+
+    /// Copy constructor (disabled)
+    SnapshotBuffer(const SnapshotBuffer &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const SnapshotBuffer &) = delete;
+
+    /**
+     * Get the buffer to fill with the next snapshot
+     * @return Buffer owned by the writer until Publish
+     */
+    std::vector<SnapshotItem> &GetWriteBuffer() { return mBuffers[mWrite]; }
+
+    void Publish();
+    const std::vector<SnapshotItem> &Acquire();
+};
+
+#endif //AQUARIUM_SNAPSHOTBUFFER_H
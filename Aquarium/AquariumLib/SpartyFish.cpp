@@ -6,6 +6,7 @@
 #include "pch.h"
 #include "SpartyFish.h"
 #include "Aquarium.h"
+#include "SpeciesRegistry.h"
 #include <string>
 
 using namespace std;
@@ -13,25 +14,35 @@ using namespace std;
 /// Fish filename
 const wstring SpartyFishImageName = L"images/sparty-fish.png";
 
+/// Tag sparty fish are saved with
+const string SpartyFishType = "sparty";
+
+/**
+ * Get the Sparty fish species. Looked up once, as the registry
+ * never moves a species.
+ * @return The registered species
+ */
+static const Species &SpartyFishSpecies()
+{
+    static const Species &species = SpeciesRegistry::Instance().Get(SpartyFishType);
+    return species;
+}
+
 /**
  * Constructor
  * @param aquarium Aquarium this fish is a member of
  */
-SpartyFish::SpartyFish(Aquarium *aquarium) : Fish(aquarium, SpartyFishImageName)
+SpartyFish::SpartyFish(Aquarium *aquarium) : Fish(aquarium, SpartyFishSpecies())
 {
     SetSpeed(30, 30);
 }
 
 /**
- * Save this fish to an XML node
- * @param node The parent node we are going to be a child of
- * @return
+ * Register the sparty fish species
+ * @param registry Registry to add the species to
  */
-wxXmlNode* SpartyFish::XmlSave(wxXmlNode* node)
+void SpartyFish::Register(SpeciesRegistry &registry)
 {
-    auto itemNode = Fish::XmlSave(node);
-
-    itemNode->AddAttribute(L"type", L"sparty");
-
-    return itemNode;
+    registry.Add(SpartyFishType, SpartyFishImageName, L"&Sparty Fish", L"Add a Sparty Fish", Species::Menu::Fish,
+            [](Aquarium *aquarium) -> Item* { return aquarium->Create<SpartyFish>(); });
 }
@@ -10,6 +10,8 @@
 
 #include "Fish.h"
 
+class SpeciesRegistry;
+
 class SpartyFish : public Fish {
 private:
 
@@ -25,9 +27,11 @@ public:
 
     SpartyFish(Aquarium* aquarium);
 
-    wxXmlNode* XmlSave(wxXmlNode* node) override;
+    static void Register(SpeciesRegistry &registry);
 
 
 };
 
+AQUARIUM_POOL_RELEASABLE(SpartyFish);
+
 #endif //AQUARIUM_SPARTYFISH_H
@@ -0,0 +1,265 @@
+/**
+ * @file SpatialGrid.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "SpatialGrid.h"
+#include "Item.h"
+
+#include <cmath>
+
+using namespace std;
+
+/// Largest cell column or row. Locations farther out are
+/// put in the edge cells, so the conversion to int is
+/// always defined.
+const double MaxCellCoord = 1 << 24;
+
+/**
+ * Constructor
+ * @param cellSize Width and height of a grid cell in pixels
+ */
+SpatialGrid::SpatialGrid(double cellSize) : mCellSize(cellSize)
+{
+}
+
+/**
+ * Convert a location to a cell coordinate
+ * @param v X or Y location in pixels
+ * @return Cell column or row, clamped to +/- MaxCellCoord
+ * and 0 if the location is not a number
+ */
+int SpatialGrid::CellCoord(double v) const
+{
+    auto cell = floor(v / mCellSize);
+    if (std::isnan(cell))
+    {
+        return 0;
+    }
+
+    return (int)max(-MaxCellCoord, min(cell, MaxCellCoord));
+}
+
+/**
+ * Combine a cell column and row into a hash key
+ * @param cx Cell column
+ * @param cy Cell row
+ * @return Key for mCells
+ */
+uint64_t SpatialGrid::Key(int cx, int cy)
+{
+    return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy;
+}
+
+/**
+ * Add an item to the grid at its current location
+ * @param item Item to add
+ */
+void SpatialGrid::Insert(Item *item)
+{
+    auto key = Key(CellCoord(item->GetX()), CellCoord(item->GetY()));
+    mCells[key].push_back(item);
+    mCount++;
+
+    mMaxHalfWidth = max(mMaxHalfWidth, item->GetWidth() / 2.0);
+    mMaxHalfHeight = max(mMaxHalfHeight, item->GetHeight() / 2.0);
+}
+
+/**
+ * Remove an item from a cell
+ * @param item Item to remove
+ * @param key Key of the cell the item is in
+ * @return true if the item was in the cell
+ */
+bool SpatialGrid::RemoveFromCell(Item *item, uint64_t key)
+{
+    auto cell = mCells.find(key);
+    if (cell == mCells.end())
+    {
+        return false;
+    }
+
+    auto &items = cell->second;
+    auto loc = find(items.begin(), items.end(), item);
+    if (loc == items.end())
+    {
+        return false;
+    }
+
+    *loc = items.back();
+    items.pop_back();
+    if (items.empty())
+    {
+        mCells.erase(cell);
+    }
+
+    return true;
+}
+
+/**
+ * Remove an item from the grid
+ * @param item Item to remove
+ * @param x X location the item was inserted or last moved at
+ * @param y Y location the item was inserted or last moved at
+ * @return true if the item was in the grid
+ */
+bool SpatialGrid::Remove(Item *item, double x, double y)
+{
+    if (RemoveFromCell(item, Key(CellCoord(x), CellCoord(y))))
+    {
+        mCount--;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Update the grid after an item has moved.
+ *
+ * Items that are not in the grid are ignored.
+ *
+ * @param item Item that moved
+ * @param oldX X location before the move
+ * @param oldY Y location before the move
+ */
+void SpatialGrid::Move(Item *item, double oldX, double oldY)
+{
+    auto oldCX = CellCoord(oldX), oldCY = CellCoord(oldY);
+    auto newCX = CellCoord(item->GetX()), newCY = CellCoord(item->GetY());
+    if (oldCX == newCX && oldCY == newCY)
+    {
+        // Still in the same cell, which is the usual case
+        return;
+    }
+
+    if (RemoveFromCell(item, Key(oldCX, oldCY)))
+    {
+        mCells[Key(newCX, newCY)].push_back(item);
+    }
+}
+
+/**
+ * Remove all items from the grid
+ */
+void SpatialGrid::Clear()
+{
+    mCells.clear();
+    mCount = 0;
+    mMaxHalfWidth = 0;
+    mMaxHalfHeight = 0;
+}
+
+/**
+ * Find the items whose bounding box contains a point
+ * @param x X location in pixels
+ * @param y Y location in pixels
+ * @param result Vector the items are appended to
+ */
+void SpatialGrid::QueryPoint(double x, double y, std::vector<Item*> &result) const
+{
+    auto left = CellCoord(x - mMaxHalfWidth), right = CellCoord(x + mMaxHalfWidth);
+    auto top = CellCoord(y - mMaxHalfHeight), bottom = CellCoord(y + mMaxHalfHeight);
+
+    ForEachCell(left, right, top, bottom, [&](const vector<Item*> &items) {
+        for (auto item : items)
+        {
+            double wid = item->GetWidth();
+            double hit = item->GetHeight();
+            double testX = x - item->GetX() + wid / 2;
+            double testY = y - item->GetY() + hit / 2;
+            if (testX >= 0 && testY >= 0 && testX < wid && testY < hit)
+            {
+                result.push_back(item);
+            }
+        }
+
+        return true;
+    });
+}
+
+/**
+ * Find the items whose center is within a distance of a point
+ * @param x X location in pixels
+ * @param y Y location in pixels
+ * @param radius Distance in pixels
+ * @param result Vector the items are appended to
+ */
+void SpatialGrid::QueryRadius(double x, double y, double radius, std::vector<Item*> &result) const
+{
+    auto left = CellCoord(x - radius), right = CellCoord(x + radius);
+    auto top = CellCoord(y - radius), bottom = CellCoord(y + radius);
+
+    ForEachCell(left, right, top, bottom, [&](const vector<Item*> &items) {
+        for (auto item : items)
+        {
+            auto dx = item->GetX() - x;
+            auto dy = item->GetY() - y;
+            if (dx * dx + dy * dy <= radius * radius)
+            {
+                result.push_back(item);
+            }
+        }
+
+        return true;
+    });
+}
+
+/**
+ * Find the items whose bounding box overlaps a rectangle
+ * @param left Left edge in pixels
+ * @param top Top edge in pixels
+ * @param right Right edge in pixels (exclusive)
+ * @param bottom Bottom edge in pixels (exclusive)
+ * @param result Vector the items are appended to
+ */
+void SpatialGrid::QueryRect(double left, double top, double right, double bottom,
+        std::vector<Item*> &result) const
+{
+    auto cellLeft = CellCoord(left - mMaxHalfWidth), cellRight = CellCoord(right + mMaxHalfWidth);
+    auto cellTop = CellCoord(top - mMaxHalfHeight), cellBottom = CellCoord(bottom + mMaxHalfHeight);
+
+    ForEachCell(cellLeft, cellRight, cellTop, cellBottom, [&](const vector<Item*> &items) {
+        for (auto item : items)
+        {
+            double halfWid = item->GetWidth() / 2.0;
+            double halfHit = item->GetHeight() / 2.0;
+            if (item->GetX() + halfWid > left && item->GetX() - halfWid < right &&
+                    item->GetY() + halfHit > top && item->GetY() - halfHit < bottom)
+            {
+                result.push_back(item);
+            }
+        }
+
+        return true;
+    });
+}
+
+/**
+ * Determine if any item center is closer than a distance to a point
+ * @param x X location in pixels
+ * @param y Y location in pixels
+ * @param radius Distance in pixels
+ * @return true if some item center is less than radius away
+ */
+bool SpatialGrid::AnyWithin(double x, double y, double radius) const
+{
+    auto left = CellCoord(x - radius), right = CellCoord(x + radius);
+    auto top = CellCoord(y - radius), bottom = CellCoord(y + radius);
+
+    // Stop at the first item found
+    return !ForEachCell(left, right, top, bottom, [&](const vector<Item*> &items) {
+        for (auto item : items)
+        {
+            auto dx = item->GetX() - x;
+            auto dy = item->GetY() - y;
+            if (dx * dx + dy * dy < radius * radius)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    });
+}
@@ -0,0 +1,118 @@
+/**
+ * @file SpatialGrid.h
+ * @author joeyv
+ *
+ * Uniform grid that indexes items by location.
+ */
+
+#ifndef AQUARIUM_SPATIALGRID_H
+#define AQUARIUM_SPATIALGRID_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class Item;
+
+/**
+ * Uniform grid that indexes items by location.
+ *
+ * Each item is stored in the cell that contains its center.
+ * Cells are kept in a hash table, so only occupied cells use
+ * memory and the grid needs no fixed extent. Queries pad the
+ * searched cells by the largest item inserted so far, so an
+ * item is found wherever its bounding box reaches. A query
+ * never looks at more cells than are occupied.
+ */
+class SpatialGrid {
+private:
+    /// Width and height of a cell in pixels
+    double mCellSize;
+
+    /// The items in each occupied cell
+    std::unordered_map<uint64_t, std::vector<Item*>> mCells;
+
+    /// Largest half width of any item inserted
+    double mMaxHalfWidth = 0;
+
+    /// Largest half height of any item inserted
+    double mMaxHalfHeight = 0;
+
+    /// Number of items in the grid
+    size_t mCount = 0;
+
+    int CellCoord(double v) const;
+    static uint64_t Key(int cx, int cy);
+    bool RemoveFromCell(Item *item, uint64_t key);
+
+    /**
+     * Visit the occupied cells in a range of cells.
+     *
+     * A range with more cells than there are occupied cells
+     * is not walked. The occupied cells are scanned for ones
+     * in the range instead, so a huge range costs no more
+     * than the number of occupied cells.
+     *
+     * @param left First cell column
+     * @param right Last cell column
+     * @param top First cell row
+     * @param bottom Last cell row
+     * @param visit Called with the items in each occupied cell,
+     * returns false to stop visiting
+     * @return false if visit stopped the search
+     */
+    template <class Visit>
+    bool ForEachCell(int left, int right, int top, int bottom, Visit visit) const
+    {
+        double cells = ((double)right - left + 1) * ((double)bottom - top + 1);
+        if (cells > (double)mCells.size())
+        {
+            for (const auto &cell : mCells)
+            {
+                auto cx = (int)(uint32_t)(cell.first >> 32);
+                auto cy = (int)(uint32_t)cell.first;
+                if (cx >= left && cx <= right && cy >= top && cy <= bottom && !visit(cell.second))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        for (int cx = left; cx <= right; cx++)
+        {
+            for (int cy = top; cy <= bottom; cy++)
+            {
+                auto cell = mCells.find(Key(cx, cy));
+                if (cell != mCells.end() && !visit(cell->second))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+public:
+    explicit SpatialGrid(double cellSize);
+
+    void Insert(Item *item);
+    bool Remove(Item *item, double x, double y);
+    void Move(Item *item, double oldX, double oldY);
+    void Clear();
+
+    void QueryPoint(double x, double y, std::vector<Item*> &result) const;
+    void QueryRadius(double x, double y, double radius, std::vector<Item*> &result) const;
+    void QueryRect(double left, double top, double right, double bottom, std::vector<Item*> &result) const;
+    bool AnyWithin(double x, double y, double radius) const;
+
+    /**
+     * Get the number of items in the grid
+     * @return Number of items
+     */
+    size_t GetCount() const { return mCount; }
+};
+
+#endif //AQUARIUM_SPATIALGRID_H
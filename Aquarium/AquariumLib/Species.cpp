@@ -0,0 +1,48 @@
+/**
+ * @file Species.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "Species.h"
+#include "SpriteCache.h"
+
+using namespace std;
+
+/**
+ * Constructor
+ * @param type Tag items of this species are saved with
+ * @param image Image file items of this species display
+ * @param name Menu item label
+ * @param help Menu item help string
+ * @param menu The menu this species is added from
+ * @param factory Creates an item of this species
+ * @param index Position of this species in the registry
+ */
+Species::Species(string_view type, const wstring &image, const wstring &name,
+        const wstring &help, Menu menu, Factory factory, int index) :
+        mType(type), mImage(image), mName(name), mHelp(help),
+        mMenu(menu), mFactory(factory), mIndex(index)
+{
+}
+
+/**
+ * Get the sprite items of this species display.
+ *
+ * While any item of the species exists this does not
+ * need to look the image filename up in the SpriteCache.
+ *
+ * @return Shared pointer to the sprite
+ */
+shared_ptr<Sprite> Species::GetSprite() const
+{
+    lock_guard<mutex> lock(mSpriteMutex);
+    auto sprite = mSprite.lock();
+    if (sprite == nullptr)
+    {
+        sprite = SpriteCache::Instance().Get(mImage);
+        mSprite = sprite;
+    }
+
+    return sprite;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file Species.h
+ * @author joeyv
+ *
+ * One kind of item that can be put in the aquarium.
+ */
+
+#ifndef AQUARIUM_SPECIES_H
+#define AQUARIUM_SPECIES_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "Sprite.h"
+
+class Aquarium;
+class Item;
+
+/**
+ * One kind of item that can be put in the aquarium.
+ *
+ * A species knows the tag its items are saved with, the
+ * image they display, where it appears in the menus and
+ * how to create one of its items. Species are owned by the
+ * SpeciesRegistry and never move, so a pointer to one can
+ * be compared instead of its tag.
+ */
+class Species {
+public:
+    /// The menu a species is added from
+    enum class Menu {Fish, Decor};
+
+    /// Function that creates an item of a species in an aquarium
+    typedef Item *(*Factory)(Aquarium *aquarium);
+
+private:
+    /// Tag items of this species are saved with
+    std::string mType;
+
+    /// Image file items of this species display
+    std::wstring mImage;
+
+    /// Menu item label
+    std::wstring mName;
+
+    /// Menu item help string
+    std::wstring mHelp;
+
+    /// The menu this species is added from
+    Menu mMenu;
+
+    /// Creates an item of this species
+    Factory mFactory;
+
+    /// Position of this species in the registry
+    int mIndex;
+
+    /// The sprite while any item of this species is using it
+    mutable std::weak_ptr<Sprite> mSprite;
+
+    /// Guards mSprite, as items are built on file job threads
+    mutable std::mutex mSpriteMutex;
+
+public:
+    Species(std::string_view type, const std::wstring &image, const std::wstring &name,
+            const std::wstring &help, Menu menu, Factory factory, int index);
+
+    /// Default constructor (disabled)
+    Species() = delete;
+
+    /// Copy constructor (disabled)
+    Species(const Species &) = delete;
+
+    /// Assignment operator
+    void operator=(const Species &) = delete;
+
+    /**
+     * Get the tag items of this species are saved with
+     * @return Type tag
+     */
+    std::string_view GetType() const { return mType; }
+
+    /**
+     * Get the image file items of this species display
+     * @return Image filename
+     */
+    const std::wstring &GetImage() const { return mImage; }
+
+    /**
+     * Get the label of the menu item that adds this species
+     * @return Menu item label
+     */
+    const std::wstring &GetName() const { return mName; }
+
+    /**
+     * Get the help string of the menu item that adds this species
+     * @return Menu item help string
+     */
+    const std::wstring &GetHelp() const { return mHelp; }
+
+    /**
+     * Get the menu this species is added from
+     * @return Menu
+     */
+    Menu GetMenu() const { return mMenu; }
+
+    /**
+     * Get the position of this species in the registry
+     * @return Index, starting at 0
+     */
+    int GetIndex() const { return mIndex; }
+
+    std::shared_ptr<Sprite> GetSprite() const;
+
+    /**
+     * Create an item of this species, owned by an aquarium
+     * but not yet added to it
+     * @param aquarium Aquarium the item is a member of
+     * @return New item
+     */
+    Item *Create(Aquarium *aquarium) const { return mFactory(aquarium); }
+};
+
+#endif //AQUARIUM_SPECIES_H
@@ -0,0 +1,88 @@
+/**
+ * @file SpeciesRegistry.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "SpeciesRegistry.h"
+#include "FishBeta.h"
+#include "SpartyFish.h"
+#include "StinkyFish.h"
+#include "DecorCastle.h"
+
+using namespace std;
+
+/**
+ * Constructor
+ *
+ * Registers the built-in species. The order here is
+ * the order they appear in the menus.
+ */
+SpeciesRegistry::SpeciesRegistry()
+{
+    FishBeta::Register(*this);
+    SpartyFish::Register(*this);
+    StinkyFish::Register(*this);
+    DecorCastle::Register(*this);
+}
+
+/**
+ * Get the one species registry for this process
+ * @return Reference to the species registry
+ */
+SpeciesRegistry &SpeciesRegistry::Instance()
+{
+    static SpeciesRegistry registry;
+    return registry;
+}
+
+/**
+ * Register a species
+ * @param type Tag items of the species are saved with
+ * @param image Image file items of the species display
+ * @param name Menu item label
+ * @param help Menu item help string
+ * @param menu The menu the species is added from
+ * @param factory Creates an item of the species
+ * @return The registered species, or the one already
+ * registered with this tag
+ */
+const Species &SpeciesRegistry::Add(string_view type, const wstring &image, const wstring &name,
+        const wstring &help, Species::Menu menu, Species::Factory factory)
+{
+    auto existing = Find(type);
+    if (existing != nullptr)
+    {
+        return *existing;
+    }
+
+    mSpecies.push_back(make_unique<Species>(type, image, name, help, menu, factory, (int)mSpecies.size()));
+    auto species = mSpecies.back().get();
+
+    // Key on the tag the species owns, so the
+    // map never refers to the caller's string
+    mTypes[species->GetType()] = species;
+    return *species;
+}
+
+/**
+ * Find a species by the tag its items are saved with
+ * @param type Type tag
+ * @return Species, or null if no species has this tag
+ */
+const Species *SpeciesRegistry::Find(string_view type) const
+{
+    auto found = mTypes.find(type);
+    return found != mTypes.end() ? found->second : nullptr;
+}
+
+/**
+ * Get a species that is known to be registered
+ * @param type Type tag
+ * @return Species
+ * @throws std::out_of_range if no species has this tag
+ */
+const Species &SpeciesRegistry::Get(string_view type) const
+{
+    return *mTypes.at(type);
+}
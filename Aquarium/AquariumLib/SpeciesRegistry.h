@@ -0,0 +1,67 @@
+/**
+ * @file SpeciesRegistry.h
+ * @author joeyv
+ *
+ * Every species that can be put in the aquarium.
+ */
+
+#ifndef AQUARIUM_SPECIESREGISTRY_H
+#define AQUARIUM_SPECIESREGISTRY_H
+
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Species.h"
+
+/**
+ * Every species that can be put in the aquarium.
+ *
+ * Each Item subclass registers its species once, the
+ * first time the registry is used. The loader looks
+ * species up by tag here, the save path and drawing
+ * compare Species pointers, and the menus are built
+ * from the registered species in order.
+ */
+class SpeciesRegistry {
+private:
+    /// Registered species, in the order they were added
+    std::vector<std::unique_ptr<Species>> mSpecies;
+
+    /// Registered species, keyed by their own type tag
+    std::unordered_map<std::string_view, const Species *> mTypes;
+
+    SpeciesRegistry();
+
+public:
+    /// Copy constructor (disabled)
+    SpeciesRegistry(const SpeciesRegistry &) = delete;
+
+    /// Assignment operator
+    void operator=(const SpeciesRegistry &) = delete;
+
+    static SpeciesRegistry &Instance();
+
+    const Species &Add(std::string_view type, const std::wstring &image, const std::wstring &name,
+            const std::wstring &help, Species::Menu menu, Species::Factory factory);
+
+    const Species *Find(std::string_view type) const;
+
+    const Species &Get(std::string_view type) const;
+
+    /**
+     * Get the number of registered species
+     * @return Number of species
+     */
+    int GetCount() const { return (int)mSpecies.size(); }
+
+    /**
+     * Get a registered species by position
+     * @param index Index, from 0 to GetCount() - 1
+     * @return Species
+     */
+    const Species &GetSpecies(int index) const { return *mSpecies[index]; }
+};
+
+#endif //AQUARIUM_SPECIESREGISTRY_H
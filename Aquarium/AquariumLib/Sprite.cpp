@@ -0,0 +1,21 @@
+/**
+ * @file Sprite.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "Sprite.h"
+
+/**
+ * Constructor
+ * @param image The decoded image to display
+ */
+Sprite::Sprite(const wxImage &image) :
+        mImage(image)
+{
+    mMirrorImage = mImage.Mirror();
+    mBitmap = wxBitmap(mImage);
+    mMirrorBitmap = wxBitmap(mMirrorImage);
+    mMask = HitMask(mImage);
+    mMirrorMask = HitMask(mMirrorImage);
+}
@@ -0,0 +1,100 @@
+/**
+ * @file Sprite.h
+ * @author joeyv
+ *
+ * An image shared by every item that displays it.
+ */
+
+#ifndef AQUARIUM_SPRITE_H
+#define AQUARIUM_SPRITE_H
+
+#include <memory>
+#include <string>
+
+#include "HitMask.h"
+
+/**
+ * An image shared by every item that displays it.
+ *
+ * A sprite owns the decoded image and the bitmaps and hit
+ * masks built from it, both as loaded and mirrored. Sprites are obtained
+ * from the SpriteCache so each image file is only decoded
+ * once no matter how many items display it, and flipping an
+ * item only selects the other bitmap.
+ */
+class Sprite {
+private:
+    /// The decoded image
+    wxImage mImage;
+
+    /// The decoded image mirrored left to right
+    wxImage mMirrorImage;
+
+    /// The bitmap we display for this image
+    wxBitmap mBitmap;
+
+    /// The bitmap we display when mirrored
+    wxBitmap mMirrorBitmap;
+
+    /// Opaque pixels of the image
+    HitMask mMask;
+
+    /// Opaque pixels of the mirrored image
+    HitMask mMirrorMask;
+
+public:
+    explicit Sprite(const wxImage &image);
+
+    /// Default constructor (disabled)
+    Sprite() = delete;
+
+    /// Copy constructor (disabled)
+    Sprite(const Sprite &) = delete;
+
+    /// Assignment operator
+    void operator=(const Sprite &) = delete;
+
+    /**
+     * Get the decoded image
+     * @param mirror True to get the mirrored image
+     * @return Image for this sprite
+     */
+    const wxImage &GetImage(bool mirror = false) const
+    {
+        return mirror ? mMirrorImage : mImage;
+    }
+
+    /**
+     * Get the bitmap to draw
+     * @param mirror True to get the mirrored bitmap
+     * @return Bitmap for this sprite
+     */
+    const wxBitmap &GetBitmap(bool mirror = false) const
+    {
+        return mirror ? mMirrorBitmap : mBitmap;
+    }
+
+    /**
+     * Get the mask of opaque pixels
+     * @param mirror True to get the mask for the mirrored image
+     * @return Hit mask for this sprite
+     */
+    const HitMask &GetMask(bool mirror = false) const
+    {
+        return mirror ? mMirrorMask : mMask;
+    }
+
+    /**
+     * Get the width of the sprite
+     * @return Width in pixels
+     */
+    int GetWidth() const { return mBitmap.GetWidth(); }
+
+    /**
+     * Get the height of the sprite
+     * @return Height in pixels
+     */
+    int GetHeight() const { return mBitmap.GetHeight(); }
+};
+
+#endif //AQUARIUM_SPRITE_H
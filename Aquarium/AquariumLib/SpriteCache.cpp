@@ -0,0 +1,64 @@
+/**
+ * @file SpriteCache.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "SpriteCache.h"
+#include "ImagePreloader.h"
+
+using namespace std;
+
+/**
+ * Get the one sprite cache for this process
+ * @return Reference to the sprite cache
+ */
+SpriteCache &SpriteCache::Instance()
+{
+    static SpriteCache cache;
+    return cache;
+}
+
+/**
+ * Get the sprite for an image file, making it from the
+ * decoded image if nobody is currently using it.
+ * @param filename The image file
+ * @return Shared pointer to the sprite
+ */
+shared_ptr<Sprite> SpriteCache::Get(const wstring &filename)
+{
+    lock_guard<mutex> lock(mMutex);
+    auto &entry = mSprites[filename];
+    auto sprite = entry.lock();
+    if (sprite == nullptr)
+    {
+        sprite = make_shared<Sprite>(ImagePreloader::Instance().Get(filename));
+        entry = sprite;
+    }
+
+    return sprite;
+}
+
+/**
+ * Count the sprites that are currently loaded
+ * @return Number of sprites in use by at least one item
+ */
+int SpriteCache::GetLoadedCount()
+{
+    lock_guard<mutex> lock(mMutex);
+    int count = 0;
+    for (auto i = mSprites.begin(); i != mSprites.end(); )
+    {
+        if (i->second.expired())
+        {
+            i = mSprites.erase(i);
+        }
+        else
+        {
+            count++;
+            i++;
+        }
+    }
+
+    return count;
+}
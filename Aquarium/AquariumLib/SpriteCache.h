@@ -0,0 +1,54 @@
+/**
+ * @file SpriteCache.h
+ * @author joeyv
+ *
+ * Process-wide cache of loaded sprites.
+ */
+
+#ifndef AQUARIUM_SPRITECACHE_H
+#define AQUARIUM_SPRITECACHE_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "Sprite.h"
+
+/**
+ * Process-wide cache of loaded sprites.
+ *
+ * Sprites are keyed by image filename. The cache only
+ * holds weak references, so a sprite is released once the
+ * last item using it is destroyed and reloaded on next use.
+ *
+ * The cache may be used from any thread, but making a sprite
+ * builds bitmaps, which must happen on the main thread. Code
+ * that creates items on another thread holds on to the
+ * sprites it needs first, so nothing is made there.
+ */
+class SpriteCache {
+private:
+    /// Sprites we have loaded, keyed by filename
+    std::unordered_map<std::wstring, std::weak_ptr<Sprite>> mSprites;
+
+    /// Guards mSprites
+    std::mutex mMutex;
+
+    SpriteCache() = default;
+
+public:
+    /// Copy constructor (disabled)
+    SpriteCache(const SpriteCache &) = delete;
+
+    /// Assignment operator
+    void operator=(const SpriteCache &) = delete;
+
+    static SpriteCache &Instance();
+
+    std::shared_ptr<Sprite> Get(const std::wstring &filename);
+
+    int GetLoadedCount();
+};
+
+#endif //AQUARIUM_SPRITECACHE_H
@@ -6,6 +6,7 @@
 #include "pch.h"
 #include "StinkyFish.h"
 #include "Aquarium.h"
+#include "SpeciesRegistry.h"
 #include <string>
 
 using namespace std;
@@ -13,29 +14,35 @@ using namespace std;
 /// Fish filename
 const wstring StinkyFishImageName = L"images/stinky.png";
 
+/// Tag stinky fish are saved with
+const string StinkyFishType = "stinky";
+
+/**
+ * Get the stinky fish species. Looked up once, as the registry
+ * never moves a species.
+ * @return The registered species
+ */
+static const Species &StinkyFishSpecies()
+{
+    static const Species &species = SpeciesRegistry::Instance().Get(StinkyFishType);
+    return species;
+}
+
 /**
  * Constructor
  * @param aquarium Aquarium this fish is a member of
  */
-StinkyFish::StinkyFish(Aquarium *aquarium) : Fish(aquarium, StinkyFishImageName)
+StinkyFish::StinkyFish(Aquarium *aquarium) : Fish(aquarium, StinkyFishSpecies())
 {
     SetSpeed(300, -20);
 }
 
 /**
- * Save this fish to an XML node
- * @param node The parent node we are going to be a child of
- * @return
+ * Register the stinky fish species
+ * @param registry Registry to add the species to
  */
-wxXmlNode* StinkyFish::XmlSave(wxXmlNode* node)
+void StinkyFish::Register(SpeciesRegistry &registry)
 {
-    auto itemNode = Fish::XmlSave(node);
-
-    itemNode->AddAttribute(L"type", L"stinky");
-
-    return itemNode;
+    registry.Add(StinkyFishType, StinkyFishImageName, L"&Stinky Fish", L"Add a Stinky Fish", Species::Menu::Fish,
+            [](Aquarium *aquarium) -> Item* { return aquarium->Create<StinkyFish>(); });
 }
-
-
-
-
@@ -10,6 +10,8 @@
 
 #include "Fish.h"
 
+class SpeciesRegistry;
+
 class StinkyFish : public Fish {
 private:
 
@@ -25,8 +27,10 @@ public:
 
     StinkyFish(Aquarium* aquarium);
 
-    wxXmlNode* XmlSave(wxXmlNode* node) override;
+    static void Register(SpeciesRegistry &registry);
 
 };
 
+AQUARIUM_POOL_RELEASABLE(StinkyFish);
+
 #endif //AQUARIUM_STINKYFISH_H
@@ -0,0 +1,36 @@
+/**
+ * @file TankData.h
+ * @author joeyv
+ *
+ * The contents of a tank file as plain data.
+ */
+
+#ifndef AQUARIUM_TANKDATA_H
+#define AQUARIUM_TANKDATA_H
+
+#include <string>
+#include <vector>
+
+#include "AquaBinary.h"
+
+/**
+ * A species in the table of a TankData
+ */
+struct TankSpecies {
+    std::string type;       ///< Type tag, as in the XML type attribute
+    bool moving = false;    ///< True if items of this species save their speed
+};
+
+/**
+ * The contents of a tank file as plain data.
+ *
+ * This holds no items, images or pointers into an aquarium,
+ * so it can be read, written and handed between threads
+ * without touching the aquarium the items end up in.
+ */
+struct TankData {
+    std::vector<TankSpecies> species;       ///< Species table
+    std::vector<AquaBinaryRecord> items;    ///< Items from back to front
+};
+
+#endif //AQUARIUM_TANKDATA_H
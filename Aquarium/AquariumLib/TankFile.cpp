@@ -0,0 +1,545 @@
+/**
+ * @file TankFile.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "TankFile.h"
+#include "AquaReader.h"
+#include "AquaWriter.h"
+#include "AquaBinaryReader.h"
+#include "AquaBinaryWriter.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include <wx/filefn.h>
+#include <cmath>
+#include <mutex>
+
+using namespace std;
+
+/// Number of items between calls to the progress function
+const size_t ProgressInterval = 4096;
+
+/// Extension added to a file while it is being written
+const wchar_t *TemporaryExtension = L".part";
+
+/// Smallest piece of a .aqua file parsed on its own, in bytes
+const size_t MinChunkSize = 1024 * 1024;
+
+/// Pieces a .aqua file is split into for each thread, so
+/// threads that finish early can take work from the others
+const int ChunksPerThread = 4;
+
+/// Largest location or speed accepted from a file. This is far
+/// beyond any aquarium, but keeps every item within a few
+/// thousand cells of the spatial grid in each direction.
+const double MaxCoordinate = 1e6;
+
+/**
+ * A piece of a .aqua file and the items parsed from it
+ */
+struct XmlChunk {
+    const char *begin = nullptr;            ///< First byte of the piece
+    const char *end = nullptr;              ///< End of the piece
+    std::vector<TankSpecies> species;       ///< Species in the order this piece found them
+    std::vector<AquaBinaryRecord> items;    ///< Items, indexing species
+};
+
+/**
+ * Find a species in a table, adding it if it is not there
+ * @param species Species table
+ * @param type Type tag of the species
+ * @return Index of the species in the table
+ */
+static uint32_t FindSpecies(vector<TankSpecies> &species, string_view type)
+{
+    // There are only a handful of species, so a
+    // linear search of the table is fastest
+    for (size_t i = 0; i < species.size(); i++)
+    {
+        if (species[i].type == type)
+        {
+            return (uint32_t)i;
+        }
+    }
+
+    species.push_back(TankSpecies{string(type)});
+    return (uint32_t)species.size() - 1;
+}
+
+/**
+ * Is a location or speed from a file usable?
+ * @param v Value from the file
+ * @return true if the value is finite and no larger than MaxCoordinate
+ */
+static bool IsValidCoordinate(double v)
+{
+    return std::isfinite(v) && abs(v) <= MaxCoordinate;
+}
+
+/**
+ * Is an item record from a file usable?
+ *
+ * Only the location and speed are checked. Whether the
+ * species index is in the species table is up to the caller.
+ *
+ * @param record Record to test
+ * @return true if the location and speed are all valid
+ */
+bool TankFile::IsValidRecord(const AquaBinaryRecord &record)
+{
+    return IsValidCoordinate(record.x) && IsValidCoordinate(record.y) &&
+            IsValidCoordinate(record.speedX) && IsValidCoordinate(record.speedY);
+}
+
+/**
+ * Add the item element a reader is positioned at to a list of items
+ * @param reader Reader positioned at an item element
+ * @param species Species table, the item species is added if new
+ * @param items Items to add the item to
+ * @return false if the item location or speed is not usable
+ */
+static bool ReadXmlItem(const AquaReader &reader, vector<TankSpecies> &species, vector<AquaBinaryRecord> &items)
+{
+    AquaBinaryRecord record;
+    record.species = FindSpecies(species, reader.GetAttribute("type"));
+    record.x = reader.GetDouble("x", 0);
+    record.y = reader.GetDouble("y", 0);
+
+    if (reader.HasAttribute("x-speed") || reader.HasAttribute("y-speed"))
+    {
+        species[record.species].moving = true;
+        record.speedX = reader.GetDouble("x-speed", 0);
+        record.speedY = reader.GetDouble("y-speed", 0);
+    }
+
+    if (!TankFile::IsValidRecord(record))
+    {
+        return false;
+    }
+
+    items.push_back(record);
+    return true;
+}
+
+/**
+ * Find the next item start tag in a .aqua file
+ * @param from Where to start looking
+ * @param end End of the file
+ * @return Start of the tag, or end if there is none
+ */
+static const char *FindItemTag(const char *from, const char *end)
+{
+    const string_view tag = "<item";
+    while (from < end)
+    {
+        auto lt = (const char *)memchr(from, '<', end - from);
+        if (lt == nullptr || (size_t)(end - lt) <= tag.size())
+        {
+            break;
+        }
+
+        auto next = lt[tag.size()];
+        if (memcmp(lt, tag.data(), tag.size()) == 0 &&
+                (next == ' ' || next == '\t' || next == '\r' || next == '\n' || next == '/' || next == '>'))
+        {
+            return lt;
+        }
+
+        from = lt + 1;
+    }
+
+    return end;
+}
+
+/**
+ * Read a tank file of either format.
+ *
+ * Binary tank files are recognized by their first bytes.
+ * Anything else is read as .aqua XML, split over a number
+ * of threads if the file is large enough to be worth it.
+ *
+ * @param filename File to read
+ * @param data Data to fill with the file contents
+ * @param progress Function told of progress, may be null
+ * @param threads Number of threads to parse XML on
+ * @return false if the file could not be read or the read was cancelled
+ */
+bool TankFile::Read(const wxString &filename, TankData &data, const Progress &progress, int threads)
+{
+    data.species.clear();
+    data.items.clear();
+
+    {
+        AquaBinaryReader binary(filename);
+        if (binary.IsBinary())
+        {
+            return ReadBinary(binary, data, progress);
+        }
+    }
+
+    if (threads > 1)
+    {
+        auto result = ReadXmlParallel(filename, data, progress, threads);
+        if (result != ParallelResult::Serial)
+        {
+            return result == ParallelResult::Read;
+        }
+
+        data.species.clear();
+        data.items.clear();
+    }
+
+    return ReadXml(filename, data, progress);
+}
+
+/**
+ * Read a binary tank file
+ * @param reader Reader for the file
+ * @param data Data to fill with the file contents
+ * @param progress Function told of progress, may be null
+ * @return false if the file is damaged, has an unusable
+ * location or speed, or the read was cancelled
+ */
+bool TankFile::ReadBinary(const AquaBinaryReader &reader, TankData &data, const Progress &progress)
+{
+    if (reader.HasError())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < reader.GetSpeciesCount(); i++)
+    {
+        data.species.push_back(TankSpecies{string(reader.GetSpecies(i))});
+    }
+
+    auto count = reader.GetCount();
+    data.items.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i % ProgressInterval == 0 && progress != nullptr && !progress(double(i) / count))
+        {
+            return false;
+        }
+
+        auto &record = data.items[i];
+        record = reader.GetRecord(i);
+        if (record.species >= data.species.size() || !IsValidRecord(record))
+        {
+            return false;
+        }
+
+        // The binary format does not say which species
+        // save their speed, so go by whether any moves
+        if (record.speedX != 0 || record.speedY != 0)
+        {
+            data.species[record.species].moving = true;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Read a .aqua XML file
+ * @param filename File to read
+ * @param data Data to fill with the file contents
+ * @param progress Function told of progress, may be null
+ * @return false if the file is not a .aqua file, has an
+ * unusable location or speed, or the read was cancelled
+ */
+bool TankFile::ReadXml(const wxString &filename, TankData &data, const Progress &progress)
+{
+    AquaReader reader(filename);
+    if (!reader.IsOpen() || !reader.Next() || reader.GetName() != "aqua")
+    {
+        return false;
+    }
+
+    // Items are the children of the root element
+    while (reader.Next())
+    {
+        if (reader.GetDepth() != 2 || reader.GetName() != "item")
+        {
+            continue;
+        }
+
+        if (data.items.size() % ProgressInterval == 0 && progress != nullptr && !progress(reader.GetProgress()))
+        {
+            return false;
+        }
+
+        if (!ReadXmlItem(reader, data.species, data.items))
+        {
+            return false;
+        }
+    }
+
+    return !reader.HasError();
+}
+
+/**
+ * Read a .aqua XML file on a number of threads.
+ *
+ * The file is mapped into memory and split into pieces at
+ * item start tags. The pieces are parsed at the same time,
+ * each on the assumption that it starts just inside the root
+ * element, then the items are joined in file order. The
+ * assumption is checked by making sure every piece but the
+ * last also ends just inside the root element. If it fails,
+ * for example because a split fell inside a comment or a
+ * nested element, the caller reads the file serially.
+ *
+ * @param filename File to read
+ * @param data Data to fill with the file contents
+ * @param progress Function told of progress, may be null
+ * @param threads Number of threads to parse on
+ * @return Read if the file was read, Failed if the read was
+ * cancelled or an item is unusable, Serial if the file
+ * should be read serially
+ */
+TankFile::ParallelResult TankFile::ReadXmlParallel(const wxString &filename, TankData &data,
+        const Progress &progress, int threads)
+{
+    MappedFile file(filename);
+    auto begin = file.GetData();
+    auto size = file.GetSize();
+    auto end = begin + size;
+
+    auto count = min(threads * ChunksPerThread, (int)(size / MinChunkSize));
+    if (count < 2)
+    {
+        return ParallelResult::Serial;
+    }
+
+    vector<XmlChunk> chunks;
+    auto start = begin;
+    for (int i = 1; i < count; i++)
+    {
+        auto split = FindItemTag(max(start + 1, begin + size / count * i), end);
+        if (split == end)
+        {
+            break;
+        }
+
+        chunks.emplace_back();
+        chunks.back().begin = start;
+        chunks.back().end = split;
+        start = split;
+    }
+
+    chunks.emplace_back();
+    chunks.back().begin = start;
+    chunks.back().end = end;
+
+    // Parsed bytes are added up across the threads, and
+    // whichever thread gets the lock reports progress
+    atomic<size_t> parsed {0};
+    atomic<bool> cancelled {false};
+    atomic<bool> invalid {false};
+    atomic<bool> serial {false};
+    mutex progressMutex;
+
+    auto parse = [&](int index) {
+        auto &chunk = chunks[index];
+        bool first = index == 0;
+        bool last = index == (int)chunks.size() - 1;
+
+        AquaReader reader(chunk.begin, chunk.end, first ? 0 : 1);
+        if (first && (!reader.Next() || reader.GetName() != "aqua"))
+        {
+            serial = true;
+            return;
+        }
+
+        size_t reported = 0;
+        while (!serial && !cancelled && !invalid && reader.Next())
+        {
+            if (reader.GetDepth() == 1)
+            {
+                // Only the root is at depth 1
+                serial = true;
+                return;
+            }
+
+            if (reader.GetDepth() != 2 || reader.GetName() != "item")
+            {
+                continue;
+            }
+
+            if (chunk.items.size() % ProgressInterval == 0 && progress != nullptr)
+            {
+                auto done = (size_t)(reader.GetProgress() * (chunk.end - chunk.begin));
+                auto total = parsed += done - reported;
+                reported = done;
+
+                unique_lock<mutex> lock(progressMutex, try_to_lock);
+                if (lock.owns_lock() && !progress(double(total) / size))
+                {
+                    cancelled = true;
+                }
+            }
+
+            if (!ReadXmlItem(reader, chunk.species, chunk.items))
+            {
+                invalid = true;
+                return;
+            }
+        }
+
+        if (reader.HasError() || reader.GetOpen() != (last ? 0 : 1))
+        {
+            serial = true;
+        }
+
+        parsed += (chunk.end - chunk.begin) - reported;
+    };
+
+    ThreadPool pool(threads);
+    pool.ParallelFor(0, (int)chunks.size(), 1, [&](int first, int last) {
+        for (int i = first; i < last; i++)
+        {
+            parse(i);
+        }
+    });
+
+    if (cancelled || invalid)
+    {
+        return ParallelResult::Failed;
+    }
+
+    if (serial)
+    {
+        return ParallelResult::Serial;
+    }
+
+    // Join the pieces in file order, numbering the
+    // species in the order the whole file has them
+    size_t items = 0;
+    for (auto &chunk : chunks)
+    {
+        items += chunk.items.size();
+    }
+
+    data.items.reserve(items);
+    vector<uint32_t> species;
+    for (auto &chunk : chunks)
+    {
+        species.clear();
+        for (auto &entry : chunk.species)
+        {
+            auto index = FindSpecies(data.species, entry.type);
+            data.species[index].moving = data.species[index].moving || entry.moving;
+            species.push_back(index);
+        }
+
+        for (auto record : chunk.items)
+        {
+            record.species = species[record.species];
+            data.items.push_back(record);
+        }
+    }
+
+    return ParallelResult::Read;
+}
+
+/**
+ * Write a tank file.
+ *
+ * The file is written under a temporary name and renamed
+ * when it is complete, so a failed or cancelled write
+ * leaves any existing file in place.
+ *
+ * @param filename File to write
+ * @param data Data to write
+ * @param format Format to write the file in
+ * @param progress Function told of progress, may be null
+ * @return false if the file could not be written or the write was cancelled
+ */
+bool TankFile::Write(const wxString &filename, const TankData &data, Format format, const Progress &progress)
+{
+    auto temporary = filename + TemporaryExtension;
+
+    bool written = format == Format::Binary ?
+            WriteBinary(temporary, data, progress) : WriteXml(temporary, data, progress);
+
+    if (!written || !wxRenameFile(temporary, filename, true))
+    {
+        wxRemoveFile(temporary);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Write a binary tank file
+ * @param filename File to write
+ * @param data Data to write
+ * @param progress Function told of progress, may be null
+ * @return false if the file could not be written or the write was cancelled
+ */
+bool TankFile::WriteBinary(const wxString &filename, const TankData &data, const Progress &progress)
+{
+    vector<string_view> species;
+    for (auto &entry : data.species)
+    {
+        species.push_back(entry.type);
+    }
+
+    AquaBinaryWriter writer(filename, species, data.items.size());
+    for (size_t i = 0; i < data.items.size(); i++)
+    {
+        if (i % ProgressInterval == 0 && progress != nullptr && !progress(double(i) / data.items.size()))
+        {
+            return false;
+        }
+
+        writer.Add(data.items[i]);
+    }
+
+    return writer.Close();
+}
+
+/**
+ * Write a .aqua XML file
+ * @param filename File to write
+ * @param data Data to write
+ * @param progress Function told of progress, may be null
+ * @return false if the file could not be written or the write was cancelled
+ */
+bool TankFile::WriteXml(const wxString &filename, const TankData &data, const Progress &progress)
+{
+    AquaWriter writer(filename);
+    writer.StartElement("aqua");
+
+    for (size_t i = 0; i < data.items.size(); i++)
+    {
+        if (i % ProgressInterval == 0 && progress != nullptr && !progress(double(i) / data.items.size()))
+        {
+            return false;
+        }
+
+        auto &record = data.items[i];
+        auto &species = data.species[record.species];
+
+        writer.StartElement("item");
+        writer.Attribute("x", record.x);
+        writer.Attribute("y", record.y);
+
+        if (species.moving)
+        {
+            writer.Attribute("x-speed", record.speedX);
+            writer.Attribute("y-speed", record.speedY);
+        }
+
+        if (!species.type.empty())
+        {
+            writer.Attribute("type", species.type);
+        }
+
+        writer.EndElement();
+    }
+
+    return writer.Close();
+}
@@ -0,0 +1,56 @@
+/**
+ * @file TankFile.h
+ * @author joeyv
+ *
+ * Reading and writing tank files as TankData.
+ */
+
+#ifndef AQUARIUM_TANKFILE_H
+#define AQUARIUM_TANKFILE_H
+
+#include <functional>
+
+#include "TankData.h"
+
+class AquaBinaryReader;
+
+/**
+ * Reading and writing tank files as TankData.
+ *
+ * These only touch the file and the TankData, so they
+ * can run on a worker thread while the aquarium animates.
+ */
+class TankFile {
+public:
+    /// The formats a tank can be written in
+    enum class Format {Xml, Binary};
+
+    /**
+     * Called as a read or write makes progress, with the
+     * fraction done from 0 to 1. Return false to cancel.
+     */
+    typedef std::function<bool(double progress)> Progress;
+
+    /// Static class (disabled)
+    TankFile() = delete;
+
+    static bool Read(const wxString &filename, TankData &data, const Progress &progress = nullptr,
+            int threads = 1);
+    static bool Write(const wxString &filename, const TankData &data, Format format,
+            const Progress &progress = nullptr);
+
+    static bool IsValidRecord(const AquaBinaryRecord &record);
+
+private:
+    /// Outcome of a parallel read
+    enum class ParallelResult {Read, Failed, Serial};
+
+    static bool ReadBinary(const AquaBinaryReader &reader, TankData &data, const Progress &progress);
+    static bool ReadXml(const wxString &filename, TankData &data, const Progress &progress);
+    static ParallelResult ReadXmlParallel(const wxString &filename, TankData &data, const Progress &progress,
+            int threads);
+    static bool WriteBinary(const wxString &filename, const TankData &data, const Progress &progress);
+    static bool WriteXml(const wxString &filename, const TankData &data, const Progress &progress);
+};
+
+#endif //AQUARIUM_TANKFILE_H
@@ -0,0 +1,185 @@
+/**
+ * @file ThreadPool.cpp
+ * @author joeyv
+ */
+
+#include "pch.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+/**
+ * Constructor
+ * @param threads Number of threads to run loops on,
+ * including the thread that calls ParallelFor
+ */
+ThreadPool::ThreadPool(int threads)
+{
+    if (threads < 1)
+    {
+        threads = 1;
+    }
+
+    for (int i = 0; i < threads; i++)
+    {
+        mQueues.push_back(make_unique<Queue>());
+    }
+
+    for (int i = 0; i < threads - 1; i++)
+    {
+        mThreads.emplace_back(&ThreadPool::Worker, this, i);
+    }
+}
+
+/**
+ * Destructor, stops the worker threads
+ */
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> lock(mWakeMutex);
+        mStop = true;
+    }
+    mWake.notify_all();
+
+    for (auto &thread : mThreads)
+    {
+        thread.join();
+    }
+}
+
+/**
+ * Run a loop body over a range of items in parallel.
+ *
+ * The range is split into chunks of grain items, and the
+ * body is called once per chunk from any of the threads.
+ * Chunks must not depend on each other. This returns when
+ * every chunk has finished.
+ *
+ * @param begin First item
+ * @param end One past the last item
+ * @param grain Number of items in a chunk
+ * @param body Loop body to call for each chunk
+ */
+void ThreadPool::ParallelFor(int begin, int end, int grain, const Body &body)
+{
+    if (grain < 1)
+    {
+        grain = 1;
+    }
+
+    if (mThreads.empty() || end - begin <= grain)
+    {
+        if (begin < end)
+        {
+            body(begin, end);
+        }
+        return;
+    }
+
+    lock_guard<mutex> run(mRunMutex);
+
+    // Deal the chunks out in contiguous runs, so each thread
+    // starts on its own part of the arrays
+    int chunks = (end - begin + grain - 1) / grain;
+    int queues = (int)mQueues.size();
+    mBody = &body;
+    mRemaining = chunks;
+    for (int c = 0; c < chunks; c++)
+    {
+        int first = begin + c * grain;
+        auto &queue = *mQueues[(int64_t)c * queues / chunks];
+        lock_guard<mutex> lock(queue.mutex);
+        queue.chunks.emplace_back(first, min(first + grain, end));
+    }
+
+    {
+        lock_guard<mutex> lock(mWakeMutex);
+        mGeneration++;
+    }
+    mWake.notify_all();
+
+    RunChunks(queues - 1);
+
+    unique_lock<mutex> lock(mDoneMutex);
+    mDone.wait(lock, [this] { return mRemaining == 0; });
+    mBody = nullptr;
+}
+
+/**
+ * Worker thread loop
+ * @param index Index of the queue of this thread
+ */
+void ThreadPool::Worker(int index)
+{
+    uint64_t generation = 0;
+    while (true)
+    {
+        {
+            unique_lock<mutex> lock(mWakeMutex);
+            mWake.wait(lock, [&] { return mStop || mGeneration != generation; });
+            if (mStop)
+            {
+                return;
+            }
+
+            generation = mGeneration;
+        }
+
+        RunChunks(index);
+    }
+}
+
+/**
+ * Run chunks until there are none left to take
+ * @param index Index of the queue of this thread
+ */
+void ThreadPool::RunChunks(int index)
+{
+    pair<int, int> chunk;
+    while (TakeChunk(index, chunk))
+    {
+        (*mBody)(chunk.first, chunk.second);
+
+        if (--mRemaining == 0)
+        {
+            lock_guard<mutex> lock(mDoneMutex);
+            mDone.notify_all();
+        }
+    }
+}
+
+/**
+ * Take a chunk from the front of our own queue, or
+ * steal one from the back of another thread's queue
+ * @param index Index of the queue of this thread
+ * @param chunk Receives the chunk range
+ * @return false if there are no chunks left anywhere
+ */
+bool ThreadPool::TakeChunk(int index, std::pair<int, int> &chunk)
+{
+    int queues = (int)mQueues.size();
+    for (int i = 0; i < queues; i++)
+    {
+        auto &queue = *mQueues[(index + i) % queues];
+        lock_guard<mutex> lock(queue.mutex);
+        if (queue.chunks.empty())
+        {
+            continue;
+        }
+
+        if (i == 0)
+        {
+            chunk = queue.chunks.front();
+            queue.chunks.pop_front();
+        }
+        else
+        {
+            chunk = queue.chunks.back();
+            queue.chunks.pop_back();
+        }
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file ThreadPool.h
+ * @author joeyv
+ *
+ * Work-stealing thread pool for parallel loops.
+ */
+
+#ifndef AQUARIUM_THREADPOOL_H
+#define AQUARIUM_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Work-stealing thread pool for parallel loops.
+ *
+ * ParallelFor splits a range into chunks and deals them out
+ * to a queue per thread. Each thread takes chunks from the
+ * front of its own queue, and when that is empty steals from
+ * the back of the others, so threads that finish early help
+ * the ones that are behind. The calling thread works too.
+ */
+class ThreadPool {
+public:
+    /// A loop body run on the items begin to end - 1
+    typedef std::function<void(int begin, int end)> Body;
+
+private:
+    /// Chunks waiting to be run by one thread
+    struct Queue {
+        std::mutex mutex;                           ///< Guards chunks
+        std::deque<std::pair<int, int>> chunks;     ///< Chunk ranges
+    };
+
+    /// One queue per worker, then one for the calling thread
+    std::vector<std::unique_ptr<Queue>> mQueues;
+
+    /// The worker threads
+    std::vector<std::thread> mThreads;
+
+    /// Body of the loop being run
+    const Body *mBody = nullptr;
+
+    /// Chunks of the loop not yet finished
+    std::atomic<int> mRemaining {0};
+
+    /// Guards mGeneration and mStop
+    std::mutex mWakeMutex;
+
+    /// Wakes the workers when a loop starts
+    std::condition_variable mWake;
+
+    /// Count of loops started, so workers know there is a new one
+    uint64_t mGeneration = 0;
+
+    /// Set to stop the workers
+    bool mStop = false;
+
+    /// Guards waiting for mRemaining to reach zero
+    std::mutex mDoneMutex;
+
+    /// Signalled when the last chunk of a loop finishes
+    std::condition_variable mDone;
+
+    /// Only one loop runs at a time
+    std::mutex mRunMutex;
+
+    void Worker(int index);
+    void RunChunks(int index);
+    bool TakeChunk(int index, std::pair<int, int> &chunk);
+
+public:
+    explicit ThreadPool(int threads);
+    virtual ~ThreadPool();
+
+    /// Default constructor (disabled)
+    ThreadPool() = delete;
+
+    /// Copy constructor (disabled)
+    ThreadPool(const ThreadPool &) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const ThreadPool &) = delete;
+
+    void ParallelFor(int begin, int end, int grain, const Body &body);
+
+    /**
+     * Get the number of threads that run loops
+     * @return Thread count, including the calling thread
+     */
+    int GetThreadCount() const { return (int)mThreads.size() + 1; }
+};
+
+#endif //AQUARIUM_THREADPOOL_H
@@ -9,11 +9,11 @@
 #define AQUARIUM_IDS_H
 
 enum IDs {
-    IDM_ADDFISHBETA = wxID_HIGHEST + 1,
-    IDM_ADDFISHNEMO,
-    IDM_ADDFISHANGEL,
-    IDM_ADDFISHCARP,
-    IDM_ADDDECORCASTLE
+    IDM_FILECANCEL = wxID_HIGHEST + 1,
+
+    /// First of the ids of the Add Fish and Add Decor menu
+    /// items, one for each species in the SpeciesRegistry
+    IDM_ADDSPECIES
 };
 
 #endif //AQUARIUM_IDS_H
@@ -0,0 +1,147 @@
+/**
+ * @file main.cpp
+ * @author joeyv
+ *
+ * Simulate and render an aquarium with no window.
+ *
+ * Usage: AquariumSim file.aqua [updates] [frames] [output.png]
+ *
+ * Run from the directory that contains images/, like the
+ * application itself. Loads the file, runs a number of fixed
+ * step updates, then renders a number of frames offscreen and
+ * reports the rate of each.
+ *
+ * No window is opened, but drawing still uses wxWidgets
+ * bitmaps, which need a display on GTK. On a machine without
+ * one, run it under Xvfb, e.g. xvfb-run AquariumSim file.aqua
+ */
+
+#include <pch.h>
+#include <Aquarium.h>
+#include <OffscreenRenderer.h>
+#include <wx/filename.h>
+#include <chrono>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+/// Simulation step in seconds
+const double StepTime = 1.0 / 120;
+
+/// Default number of updates to run
+const int DefaultUpdates = 1000;
+
+/// Default number of frames to render
+const int DefaultFrames = 100;
+
+/**
+ * Seconds since a starting time
+ * @param start Starting time
+ * @return Elapsed seconds
+ */
+static double SecondsSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Parse a count given on the command line
+ * @param text Argument text
+ * @param count Set to the count if the text is one
+ * @return true if the text is a whole number from 1 to INT_MAX
+ */
+static bool ParseCount(const char *text, int &count)
+{
+    char *end;
+    errno = 0;
+    auto value = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || value < 1 || value > INT_MAX)
+    {
+        return false;
+    }
+
+    count = (int)value;
+    return true;
+}
+
+/**
+ * Print how to run the program
+ * @param program Name the program was run as
+ * @return Exit status for a usage error
+ */
+static int Usage(const char *program)
+{
+    fprintf(stderr, "Usage: %s file.aqua [updates] [frames] [output.png]\n", program);
+    fprintf(stderr, "updates and frames are whole numbers of at least 1\n");
+    fprintf(stderr, "Rendering needs a display, use xvfb-run where there is none\n");
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    int updates = DefaultUpdates;
+    int frames = DefaultFrames;
+    if (argc < 2 || (argc > 2 && !ParseCount(argv[2], updates)) ||
+            (argc > 3 && !ParseCount(argv[3], frames)))
+    {
+        return Usage(argv[0]);
+    }
+
+    wxInitializer initializer;
+    if (!initializer.IsOk())
+    {
+        fprintf(stderr, "Unable to initialize wxWidgets\n");
+        return 1;
+    }
+
+    wxInitAllImageHandlers();
+
+    wxString filename(argv[1]);
+
+    if (!wxFileName::FileExists(filename))
+    {
+        fprintf(stderr, "Unable to open %s\n", argv[1]);
+        return 1;
+    }
+
+    Aquarium aquarium;
+
+    auto start = chrono::steady_clock::now();
+    if (!aquarium.Load(filename))
+    {
+        fprintf(stderr, "Unable to read %s\n", argv[1]);
+        return 1;
+    }
+    printf("load: %.1f ms\n", SecondsSince(start) * 1000);
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < updates; i++)
+    {
+        aquarium.Update(StepTime);
+    }
+    auto seconds = SecondsSince(start);
+    printf("update: %d steps in %.1f ms, %.1f steps/s\n",
+            updates, seconds * 1000, updates / seconds);
+
+    OffscreenRenderer renderer(aquarium.GetWidth(), aquarium.GetHeight());
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++)
+    {
+        renderer.Render(&aquarium);
+    }
+    seconds = SecondsSince(start);
+    printf("render: %d frames in %.1f ms, %.1f fps\n",
+            frames, seconds * 1000, frames / seconds);
+
+    if (argc > 4 && !renderer.SaveImage(argv[4]))
+    {
+        fprintf(stderr, "Unable to write %s\n", argv[4]);
+        return 1;
+    }
+
+    return 0;
+}
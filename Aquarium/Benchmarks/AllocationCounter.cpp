@@ -0,0 +1,42 @@
+/**
+ * @file AllocationCounter.cpp
+ * @author joeyv
+ */
+
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/// Number of allocations since the program started
+static std::atomic<uint64_t> AllocationCount{0};
+
+/**
+ * Get the number of allocations made so far
+ * @return Allocation count
+ */
+uint64_t AllocationCounter::GetCount()
+{
+    return AllocationCount.load(std::memory_order_relaxed);
+}
+
+void *operator new(std::size_t size)
+{
+    AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (auto p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
@@ -0,0 +1,25 @@
+/**
+ * @file AllocationCounter.h
+ * @author joeyv
+ *
+ * Counts heap allocations made through operator new.
+ */
+
+#ifndef AQUARIUM_ALLOCATIONCOUNTER_H
+#define AQUARIUM_ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+/**
+ * Counts heap allocations made through operator new.
+ *
+ * The benchmark executable replaces the global operator new,
+ * so this counts every allocation made by the library and
+ * by wxWidgets C++ code.
+ */
+class AllocationCounter {
+public:
+    static uint64_t GetCount();
+};
+
+#endif //AQUARIUM_ALLOCATIONCOUNTER_H
@@ -0,0 +1,616 @@
+/**
+ * @file AquariumBenchmark.cpp
+ * @author joeyv
+ *
+ * Benchmarks for the Aquarium operations on the hot paths.
+ *
+ * Most benchmarks are run for tanks of 10 to 1,000,000 items.
+ */
+
+#include <pch.h>
+#include <benchmark/benchmark.h>
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <SpartyFish.h>
+#include <StinkyFish.h>
+#include <DecorCastle.h>
+#include <OffscreenRenderer.h>
+#include <TankFile.h>
+#include <SpeciesRegistry.h>
+#include <ImagePreloader.h>
+#include <ImageCache.h>
+#include <wx/filename.h>
+#include <random>
+#include <thread>
+
+using namespace std;
+
+/// Simulated frame duration in seconds
+const double FrameTime = 0.030;
+
+/// Seed so every run builds the same tank
+const unsigned int RandomSeed = 1238197374;
+
+/**
+ * Fill an aquarium with a mix of items scattered over the tank
+ * @param aquarium Aquarium to fill
+ * @param count Number of items to add
+ */
+static void Populate(Aquarium *aquarium, int64_t count)
+{
+    aquarium->GetRandom().seed(RandomSeed);
+    std::uniform_real_distribution<> x(100, aquarium->GetWidth() - 100);
+    std::uniform_real_distribution<> y(100, aquarium->GetHeight() - 100);
+
+    for (int64_t i = 0; i < count; i++)
+    {
+        Item *item;
+        switch (i % 16)
+        {
+        case 0:
+            item = aquarium->Create<DecorCastle>();
+            break;
+
+        case 1: case 2: case 3: case 4: case 5:
+            item = aquarium->Create<SpartyFish>();
+            break;
+
+        case 6: case 7: case 8:
+            item = aquarium->Create<StinkyFish>();
+            break;
+
+        default:
+            item = aquarium->Create<FishBeta>();
+            break;
+        }
+
+        aquarium->Add(item);
+        item->SetLocation(x(aquarium->GetRandom()), y(aquarium->GetRandom()));
+    }
+}
+
+/**
+ * Make the data for a tank with the same mix of items as
+ * Populate. Loading it with SetTankData places each item
+ * where the data says rather than searching for a free
+ * location, so tanks of millions of items load quickly.
+ * @param count Number of items
+ * @return Tank data, with random locations and fish speeds
+ */
+static TankData MakeTankData(int64_t count)
+{
+    std::mt19937 random(RandomSeed);
+    std::uniform_real_distribution<> x(100, 900);
+    std::uniform_real_distribution<> y(100, 700);
+    std::uniform_real_distribution<> speed(-50, 50);
+
+    TankData data;
+    data.species.push_back(TankSpecies{"castle", false});
+    data.species.push_back(TankSpecies{"sparty", true});
+    data.species.push_back(TankSpecies{"stinky", true});
+    data.species.push_back(TankSpecies{"beta", true});
+    data.items.reserve(count);
+    for (int64_t i = 0; i < count; i++)
+    {
+        AquaBinaryRecord record;
+        record.x = x(random);
+        record.y = y(random);
+        switch (i % 16)
+        {
+        case 0:
+            record.species = 0;
+            break;
+
+        case 1: case 2: case 3: case 4: case 5:
+            record.species = 1;
+            break;
+
+        case 6: case 7: case 8:
+            record.species = 2;
+            break;
+
+        default:
+            record.species = 3;
+            break;
+        }
+
+        if (record.species != 0)
+        {
+            record.speedX = speed(random);
+            record.speedY = speed(random);
+        }
+
+        data.items.push_back(record);
+    }
+
+    return data;
+}
+
+/**
+ * Get a temporary file name for save and load benchmarks
+ * @param extension Extension of the file
+ * @return Path to a file in the temporary directory
+ */
+static wxString TempFile(const wxString &extension = L".aqua")
+{
+    auto path = wxFileName::GetTempDir() + L"/aquarium";
+    if(!wxFileName::DirExists(path))
+    {
+        wxFileName::Mkdir(path);
+    }
+
+    return path + L"/benchmark" + extension;
+}
+
+/**
+ * Advance the animation by one frame
+ * @param state Benchmark state, range(0) is the number of items
+ */
+static void BM_Update(benchmark::State& state)
+{
+    Aquarium aquarium;
+    Populate(&aquarium, state.range(0));
+
+    for (auto _ : state)
+    {
+        aquarium.Update(FrameTime);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Update)->RangeMultiplier(10)->Range(10, 1000000);
+
+/**
+ * Advance the animation by one frame with the update split
+ * over a number of threads, to show how Update scales.
+ * The scaling only shows on a machine with that many cores,
+ * so thread counts above the number of cores are skipped
+ * rather than reported as if they were scaling results.
+ *
+ * The grain is set so each thread gets several chunks to
+ * balance the load, but no chunk is too small to be worth
+ * handing to another thread.
+ *
+ * @param state Benchmark state, range(0) is the number of
+ * threads and range(1) is the number of items
+ */
+static void BM_UpdateParallel(benchmark::State& state)
+{
+    auto cores = thread::hardware_concurrency();
+    if (cores != 0 && state.range(0) > (int64_t)cores)
+    {
+        state.SkipWithError("More threads than cores");
+        return;
+    }
+
+    Aquarium aquarium;
+    aquarium.SetTankData(MakeTankData(state.range(1)));
+    aquarium.SetUpdateThreads((int)state.range(0));
+    aquarium.SetGrainSize(max(1024, (int)(state.range(1) / (state.range(0) * 4))));
+
+    for (auto _ : state)
+    {
+        aquarium.Update(FrameTime);
+    }
+
+    state.counters["threads"] = (double)aquarium.GetUpdateThreads();
+    state.counters["grain"] = (double)aquarium.GetGrainSize();
+    state.counters["cores"] = (double)cores;
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+BENCHMARK(BM_UpdateParallel)->ArgsProduct({{1, 2, 4, 8, 16, 32}, {1000000, 4000000}})->UseRealTime();
+
+/**
+ * Advance and publish a frame of a tank that is mostly decor.
+ * The time should not grow with the amount of decor.
+ * @param state Benchmark state, range(0) is the number of castles
+ */
+static void BM_UpdateDecor(benchmark::State& state)
+{
+    const int NumFish = 1000;
+
+    std::mt19937 random(RandomSeed);
+    std::uniform_real_distribution<> location(100, 700);
+    std::uniform_real_distribution<> speed(-100, 100);
+
+    TankData data;
+    data.species.push_back(TankSpecies{"castle", false});
+    data.species.push_back(TankSpecies{"beta", true});
+    for (int64_t i = 0; i < state.range(0) + NumFish; i++)
+    {
+        AquaBinaryRecord record;
+        record.x = location(random);
+        record.y = location(random);
+        record.speedX = i < state.range(0) ? 0 : speed(random);
+        record.speedY = i < state.range(0) ? 0 : speed(random);
+        record.species = i < state.range(0) ? 0 : 1;
+        data.items.push_back(record);
+    }
+
+    Aquarium aquarium;
+    aquarium.SetTankData(data);
+
+    for (auto _ : state)
+    {
+        aquarium.Update(FrameTime);
+        aquarium.Publish();
+    }
+
+    state.SetItemsProcessed(state.iterations() * NumFish);
+}
+
+BENCHMARK(BM_UpdateDecor)->RangeMultiplier(10)->Range(10, 100000);
+
+/**
+ * Click at random locations in the tank
+ * @param state Benchmark state, range(0) is the number of items
+ */
+static void BM_HitTest(benchmark::State& state)
+{
+    Aquarium aquarium;
+    Populate(&aquarium, state.range(0));
+
+    std::mt19937 random(RandomSeed);
+    std::uniform_int_distribution<> x(0, aquarium.GetWidth() - 1);
+    std::uniform_int_distribution<> y(0, aquarium.GetHeight() - 1);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(aquarium.HitTest(x(random), y(random)));
+    }
+}
+
+BENCHMARK(BM_HitTest)->RangeMultiplier(10)->Range(10, 1000000);
+
+/**
+ * Click on an empty spot in a tank full of fish. The spot
+ * is inside the populated area, so the click looks at the
+ * items around it, including transparent parts of sprites.
+ * @param state Benchmark state, range(0) is the number of items
+ */
+static void BM_HitTestMiss(benchmark::State& state)
+{
+    const int MaxTries = 100000;
+
+    Aquarium aquarium;
+    Populate(&aquarium, state.range(0));
+
+    std::mt19937 random(RandomSeed);
+    std::uniform_int_distribution<> x(100, aquarium.GetWidth() - 100);
+    std::uniform_int_distribution<> y(100, aquarium.GetHeight() - 100);
+
+    int missX = 0, missY = 0;
+    bool found = false;
+    for (int i = 0; i < MaxTries && !found; i++)
+    {
+        missX = x(random);
+        missY = y(random);
+        found = aquarium.HitTest(missX, missY) == nullptr;
+    }
+
+    if (!found)
+    {
+        state.SkipWithError("No empty spot among the items");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(aquarium.HitTest(missX, missY));
+    }
+}
+
+BENCHMARK(BM_HitTestMiss)->RangeMultiplier(10)->Range(10, 1000000);
+
+/**
+ * Add items to an empty aquarium, moving each one away
+ * from the initial location as a user would
+ * @param state Benchmark state, range(0) is the number of items
+ */
+static void BM_Add(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        {
+            Aquarium aquarium;
+            state.ResumeTiming();
+
+            Populate(&aquarium, state.range(0));
+
+            state.PauseTiming();
+        }
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Add)->RangeMultiplier(10)->Range(10, 1000000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Add items that are left where they are placed, so each
+ * one has to search past all the others for a free location
+ * @param state Benchmark state, range(0) is the number of items
+ */
+static void BM_AddStacked(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        {
+            Aquarium aquarium;
+            state.ResumeTiming();
+
+            for (int64_t i = 0; i < state.range(0); i++)
+            {
+                aquarium.Add(aquarium.Create<FishBeta>());
+            }
+
+            state.PauseTiming();
+        }
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_AddStacked)->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Empty a populated aquarium, as loading a new file does
+ * @param state Benchmark state, range(0) is the number of items
+ */
+static void BM_Clear(benchmark::State& state)
+{
+    Aquarium aquarium;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        Populate(&aquarium, state.range(0));
+        state.ResumeTiming();
+
+        aquarium.Clear();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Clear)->RangeMultiplier(10)->Range(10, 100000)->Iterations(20)->Unit(benchmark::kMillisecond);
+
+/**
+ * Bring random items to the front, as clicking on them does
+ * @param state Benchmark state, range(0) is the number of items
+ */
+static void BM_SendToFront(benchmark::State& state)
+{
+    Aquarium aquarium;
+    Populate(&aquarium, state.range(0));
+
+    // Collect the items so we can pick random ones
+    vector<Item*> items;
+    for (int x = 0; x < aquarium.GetWidth(); x += 50)
+    {
+        for (int y = 0; y < aquarium.GetHeight(); y += 50)
+        {
+            auto item = aquarium.HitTest(x, y);
+            if (item != nullptr)
+            {
+                items.push_back(item);
+            }
+        }
+    }
+
+    if (items.empty())
+    {
+        state.SkipWithError("No items to send to the front");
+        return;
+    }
+
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        aquarium.SendToFront(items[i++ % items.size()]);
+    }
+}
+
+BENCHMARK(BM_SendToFront)->RangeMultiplier(10)->Range(10, 1000000);
+
+/**
+ * Save the aquarium to a .aqua file
+ * @param state Benchmark state, range(0) is the number of items
+ */
+static void BM_Save(benchmark::State& state)
+{
+    Aquarium aquarium;
+    Populate(&aquarium, state.range(0));
+    auto filename = TempFile();
+
+    for (auto _ : state)
+    {
+        aquarium.Save(filename);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Save)->RangeMultiplier(10)->Range(10, 1000000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Load the aquarium from a .aqua file
+ * @param state Benchmark state, range(0) is the number of items
+ */
+static void BM_Load(benchmark::State& state)
+{
+    auto filename = TempFile();
+    {
+        Aquarium aquarium;
+        aquarium.SetTankData(MakeTankData(state.range(0)));
+        aquarium.Save(filename);
+    }
+
+    Aquarium aquarium;
+    for (auto _ : state)
+    {
+        aquarium.Load(filename);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Load)->RangeMultiplier(10)->Range(10, 1000000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Load the aquarium from a binary tank file
+ * @param state Benchmark state, range(0) is the number of items
+ */
+static void BM_LoadBinary(benchmark::State& state)
+{
+    auto filename = TempFile(L".aquab");
+    {
+        Aquarium aquarium;
+        aquarium.SetTankData(MakeTankData(state.range(0)));
+        aquarium.SaveBinary(filename);
+    }
+
+    Aquarium aquarium;
+    for (auto _ : state)
+    {
+        aquarium.Load(filename);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_LoadBinary)->RangeMultiplier(10)->Range(10, 1000000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Build the items of a tank from data already in memory,
+ * the part of loading that does not touch the file
+ * @param state Benchmark state, range(0) is the number of items
+ */
+static void BM_SetTankData(benchmark::State& state)
+{
+    auto data = MakeTankData(state.range(0));
+
+    Aquarium aquarium;
+    for (auto _ : state)
+    {
+        aquarium.SetTankData(data);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_SetTankData)->RangeMultiplier(10)->Range(10, 1000000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Parse a .aqua file on a number of threads, without creating items
+ * @param state Benchmark state, range(0) is the number of threads
+ * and range(1) the number of items
+ */
+static void BM_ReadXmlParallel(benchmark::State& state)
+{
+    auto filename = TempFile();
+    {
+        Aquarium aquarium;
+        Populate(&aquarium, state.range(1));
+        aquarium.Save(filename);
+    }
+
+    TankData data;
+    for (auto _ : state)
+    {
+        TankFile::Read(filename, data, nullptr, (int)state.range(0));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+BENCHMARK(BM_ReadXmlParallel)->ArgsProduct({{1, 2, 4, 8, 16, 32}, {200000}})
+        ->UseRealTime()->Unit(benchmark::kMillisecond);
+
+/**
+ * Draw a whole frame into an offscreen bitmap
+ * @param state Benchmark state, range(0) is the number of items
+ */
+static void BM_Draw(benchmark::State& state)
+{
+    Aquarium aquarium;
+    Populate(&aquarium, state.range(0));
+    OffscreenRenderer renderer(aquarium.GetWidth(), aquarium.GetHeight());
+
+    for (auto _ : state)
+    {
+        renderer.Render(&aquarium);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Draw)->RangeMultiplier(10)->Range(10, 1000000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Benchmark starting up: making an aquarium with one item of
+ * each species and drawing the first frame. The items are
+ * destroyed each iteration, so every sprite is made again.
+ *
+ * Without preloading each iteration decodes every image from
+ * the disk. Preloading cannot be undone, so the preloaded
+ * case must be registered after the other one.
+ *
+ * @param state Benchmark state, range(0) is 1 to preload the images
+ */
+static void BM_FirstFrame(benchmark::State& state)
+{
+    if (state.range(0) != 0)
+    {
+        ImagePreloader::Instance().Start(Aquarium::GetImageFiles());
+        ImagePreloader::Instance().Wait();
+    }
+
+    auto &registry = SpeciesRegistry::Instance();
+    for (auto _ : state)
+    {
+        Aquarium aquarium;
+        for (int i = 0; i < registry.GetCount(); i++)
+        {
+            aquarium.Add(registry.GetSpecies(i).Create(&aquarium));
+        }
+
+        OffscreenRenderer renderer(aquarium.GetWidth(), aquarium.GetHeight());
+        renderer.Render(&aquarium);
+    }
+}
+
+BENCHMARK(BM_FirstFrame)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+/**
+ * Benchmark getting every image the aquarium displays,
+ * either by decoding the image files or from an ImageCache
+ * that is already up to date.
+ *
+ * @param state Benchmark state, range(0) is 1 to use the cache
+ */
+static void BM_LoadImages(benchmark::State& state)
+{
+    auto files = Aquarium::GetImageFiles();
+    auto cache = (wxFileName::GetTempDir() + L"/aquarium-images").ToStdWstring();
+    for (auto &file : files)
+    {
+        ImageCache::Load(cache, file);
+    }
+
+    for (auto _ : state)
+    {
+        for (auto &file : files)
+        {
+            auto image = state.range(0) != 0 ? ImageCache::Load(cache, file) : wxImage(file, wxBITMAP_TYPE_ANY);
+            benchmark::DoNotOptimize(image.GetData());
+        }
+    }
+}
+
+BENCHMARK(BM_LoadImages)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,86 @@
+/**
+ * @file MirrorBenchmark.cpp
+ * @author joeyv
+ *
+ * Measures the cost of fish turning around at the walls.
+ */
+
+#include <pch.h>
+#include <benchmark/benchmark.h>
+#include <Aquarium.h>
+#include <StinkyFish.h>
+#include <Kinematics.h>
+#include "AllocationCounter.h"
+
+using namespace std;
+
+/// Simulated frame duration in seconds
+const double FrameTime = 0.030;
+
+/**
+ * Update a tank of fast fish that bounce off the walls
+ * many times a second and count the allocations made
+ * per frame once the tank is in a steady state.
+ * @param state Benchmark state, range(0) is the number of fish
+ */
+static void BM_UpdateWallBounce(benchmark::State& state)
+{
+    Aquarium aquarium;
+    for (int i = 0; i < state.range(0); i++)
+    {
+        auto fish = aquarium.Create<StinkyFish>();
+        aquarium.Add(fish);
+    }
+
+    // Let every fish bounce off both walls at least once
+    for (int i = 0; i < 200; i++)
+    {
+        aquarium.Update(FrameTime);
+    }
+
+    auto allocations = AllocationCounter::GetCount();
+    for (auto _ : state)
+    {
+        aquarium.Update(FrameTime);
+    }
+    allocations = AllocationCounter::GetCount() - allocations;
+
+    state.counters["allocs_per_frame"] =
+            benchmark::Counter((double)allocations / (double)state.iterations());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_UpdateWallBounce)->RangeMultiplier(10)->Range(10, 10000);
+
+/**
+ * Update a tank of bouncing fish with each integration kernel
+ * @param state Benchmark state, range(0) is the Kinematics::Kernel
+ * and range(1) is the number of fish
+ */
+static void BM_UpdateKernel(benchmark::State& state)
+{
+    auto kernel = (Kinematics::Kernel)state.range(0);
+    if (!Kinematics::IsSupported(kernel))
+    {
+        state.SkipWithError("Kernel not supported on this processor");
+        return;
+    }
+
+    Aquarium aquarium;
+    aquarium.GetKinematics().SetKernel(kernel);
+    for (int i = 0; i < state.range(1); i++)
+    {
+        auto fish = aquarium.Create<StinkyFish>();
+        aquarium.Add(fish);
+    }
+
+    for (auto _ : state)
+    {
+        aquarium.Update(FrameTime);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+BENCHMARK(BM_UpdateKernel)->ArgsProduct({{(int)Kinematics::Kernel::Scalar,
+        (int)Kinematics::Kernel::SSE2, (int)Kinematics::Kernel::AVX2}, {1000, 10000}});
@@ -0,0 +1,42 @@
+/**
+ * @file benchmark_main.cpp
+ * @author joeyv
+ *
+ * Entry point for the benchmarks.
+ */
+
+#include <pch.h>
+#include <benchmark/benchmark.h>
+#include <wx/filefn.h>
+
+#include <cstdio>
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+
+    // The run_benchmarks target starts us in the directory that
+    // contains images/. When run by hand from a build directory
+    // next to it, move up to it instead.
+    if (!wxDirExists(L"images"))
+    {
+        wxSetWorkingDirectory(L"..");
+    }
+
+    // Without the images every benchmark that loads
+    // sprites would silently measure the wrong thing
+    if (!wxDirExists(L"images"))
+    {
+        fprintf(stderr, "Unable to find the images directory\n");
+        return 1;
+    }
+
+    wxInitAllImageHandlers();
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file AquaBinaryTest.cpp
+ * @author joeyv
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include "TestFiles.h"
+#include <AquaBinaryReader.h>
+#include <AquaBinaryWriter.h>
+#include <wx/filename.h>
+
+using namespace std;
+
+class AquaBinaryTest : public ::testing::Test {
+};
+
+TEST_F(AquaBinaryTest, RoundTrip){
+    // Enough items to fill the buffer several times over
+    const int NumItems = 10000;
+
+    auto filename = TempPath(L"binary1.aquab");
+    {
+        AquaBinaryWriter writer(filename, {"beta", "castle", "x"}, NumItems);
+        ASSERT_TRUE(writer.IsOpen());
+
+        for (int i = 0; i < NumItems; i++)
+        {
+            AquaBinaryRecord record;
+            record.x = i * 0.1;
+            record.y = -i;
+            record.speedX = 1.0 / (i + 1);
+            record.speedY = 1e300;
+            record.species = i % 3;
+            writer.Add(record);
+        }
+
+        ASSERT_TRUE(writer.Close());
+    }
+
+    AquaBinaryReader reader(filename);
+    ASSERT_TRUE(reader.IsBinary());
+    ASSERT_FALSE(reader.HasError());
+    ASSERT_EQ(3, reader.GetSpeciesCount());
+    ASSERT_EQ("beta", reader.GetSpecies(0));
+    ASSERT_EQ("castle", reader.GetSpecies(1));
+    ASSERT_EQ("x", reader.GetSpecies(2));
+    ASSERT_EQ(NumItems, reader.GetCount());
+
+    for (int i = 0; i < NumItems; i++)
+    {
+        auto record = reader.GetRecord(i);
+        ASSERT_EQ(i * 0.1, record.x);
+        ASSERT_EQ(-i, record.y);
+        ASSERT_EQ(1.0 / (i + 1), record.speedX);
+        ASSERT_EQ(1e300, record.speedY);
+        ASSERT_EQ(i % 3, record.species);
+    }
+}
+
+TEST_F(AquaBinaryTest, Detect){
+    // XML is not binary
+    auto xml = TempPath(L"binary2.aqua");
+    WriteFile(xml, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<aqua/>\n");
+    AquaBinaryReader reader1(xml);
+    ASSERT_FALSE(reader1.IsBinary());
+
+    // Neither is an empty or missing file
+    auto empty = TempPath(L"binary3.aquab");
+    WriteFile(empty, "");
+    AquaBinaryReader reader2(empty);
+    ASSERT_FALSE(reader2.IsBinary());
+
+    AquaBinaryReader reader3(TempPath(L"missing.aquab"));
+    ASSERT_FALSE(reader3.IsBinary());
+
+    // A file with fewer records than the header promises is damaged
+    auto filename = TempPath(L"binary4.aquab");
+    {
+        AquaBinaryWriter writer(filename, {"beta"}, 2);
+        writer.Add(AquaBinaryRecord());
+        ASSERT_FALSE(writer.Close());
+    }
+
+    AquaBinaryReader reader4(filename);
+    ASSERT_TRUE(reader4.IsBinary());
+    ASSERT_TRUE(reader4.HasError());
+}
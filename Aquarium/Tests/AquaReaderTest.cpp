@@ -0,0 +1,118 @@
+/**
+ * @file AquaReaderTest.cpp
+ * @author joeyv
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include "TestFiles.h"
+#include <AquaReader.h>
+#include <Aquarium.h>
+#include <wx/filename.h>
+
+using namespace std;
+
+class AquaReaderTest : public ::testing::Test {
+protected:
+    /**
+     * Write text to a temporary file
+     * @param name Name of the file in the temporary directory
+     * @param text Text to write
+     * @return Path to the file
+     */
+    wxString WriteFile(const wxString &name, const string &text)
+    {
+        auto filename = TempPath(name);
+        ::WriteFile(filename, text);
+        return filename;
+    }
+};
+
+TEST_F(AquaReaderTest, Elements){
+    auto filename = WriteFile(L"reader1.aqua",
+            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<!-- a <comment> -->\n"
+            "<aqua>\n"
+            "  <item x=\"1.5\" y='-2e3' type=\"a&amp;b &lt;&#65;&gt;\"/>\n"
+            "  <group note=\"x > y\"><item x=\"7\"/></group>\n"
+            "  <item type=\"beta\" x=\"oops\"></item>\n"
+            "</aqua>\n");
+
+    AquaReader reader(filename);
+    ASSERT_TRUE(reader.IsOpen());
+
+    ASSERT_TRUE(reader.Next());
+    ASSERT_EQ("aqua", reader.GetName());
+    ASSERT_EQ(1, reader.GetDepth());
+
+    ASSERT_TRUE(reader.Next());
+    ASSERT_EQ("item", reader.GetName());
+    ASSERT_EQ(2, reader.GetDepth());
+    ASSERT_EQ(1.5, reader.GetDouble("x", 0));
+    ASSERT_EQ(-2000, reader.GetDouble("y", 0));
+    ASSERT_EQ("a&b <A>", reader.GetAttribute("type"));
+    ASSERT_EQ("none", reader.GetAttribute("missing", "none"));
+
+    ASSERT_TRUE(reader.Next());
+    ASSERT_EQ("group", reader.GetName());
+    ASSERT_EQ("x > y", reader.GetAttribute("note"));
+
+    ASSERT_TRUE(reader.Next());
+    ASSERT_EQ("item", reader.GetName());
+    ASSERT_EQ(3, reader.GetDepth());
+
+    ASSERT_TRUE(reader.Next());
+    ASSERT_EQ(2, reader.GetDepth());
+    ASSERT_EQ("beta", reader.GetAttribute("type"));
+    ASSERT_EQ(42, reader.GetDouble("x", 42));
+
+    ASSERT_FALSE(reader.Next());
+    ASSERT_FALSE(reader.HasError());
+}
+
+TEST_F(AquaReaderTest, LargeFile){
+    // Many more items than fit in the read buffer at once
+    const int NumItems = 20000;
+    string text = "<aqua>";
+    for (int i = 0; i < NumItems; i++)
+    {
+        text += "<item x=\"" + to_string(i) + "\" y=\"5\" type=\"beta\"/>";
+    }
+    text += "</aqua>";
+
+    AquaReader reader(WriteFile(L"reader2.aqua", text));
+    ASSERT_TRUE(reader.Next());
+
+    int count = 0;
+    while (reader.Next())
+    {
+        ASSERT_EQ(count, reader.GetDouble("x", -1));
+        count++;
+    }
+
+    ASSERT_FALSE(reader.HasError());
+    ASSERT_EQ(NumItems, count);
+}
+
+TEST_F(AquaReaderTest, Malformed){
+    AquaReader missing(TempPath(L"no-such-file.aqua"));
+    ASSERT_FALSE(missing.IsOpen());
+    ASSERT_FALSE(missing.Next());
+
+    AquaReader truncated(WriteFile(L"reader3.aqua", "<aqua><item x=\"1\"/><item x=\"2"));
+    ASSERT_TRUE(truncated.Next());
+    ASSERT_TRUE(truncated.Next());
+    ASSERT_FALSE(truncated.Next());
+    ASSERT_TRUE(truncated.HasError());
+
+    AquaReader unclosed(WriteFile(L"reader4.aqua", "<aqua><item x=\"1\"/>"));
+    ASSERT_TRUE(unclosed.Next());
+    ASSERT_TRUE(unclosed.Next());
+    ASSERT_FALSE(unclosed.Next());
+    ASSERT_TRUE(unclosed.HasError());
+
+    // A malformed file leaves the aquarium empty
+    Aquarium aquarium;
+    aquarium.Load(WriteFile(L"reader5.aqua", "<aqua><item type=\"beta\" x=\"100\" y=\"100\"/><item"));
+    ASSERT_EQ(nullptr, aquarium.HitTest(100, 100));
+}
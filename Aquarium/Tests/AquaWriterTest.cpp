@@ -0,0 +1,83 @@
+/**
+ * @file AquaWriterTest.cpp
+ * @author joeyv
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include "TestFiles.h"
+#include <AquaWriter.h>
+#include <AquaReader.h>
+#include <wx/filename.h>
+
+using namespace std;
+
+class AquaWriterTest : public ::testing::Test {
+};
+
+TEST_F(AquaWriterTest, Format){
+    auto filename = TempPath(L"writer1.aqua");
+    {
+        AquaWriter writer(filename);
+        ASSERT_TRUE(writer.IsOpen());
+
+        writer.StartElement("aqua");
+        writer.StartElement("item");
+        writer.Attribute("x", 100.0);
+        writer.Attribute("y", -0.125);
+        writer.Attribute("big", 1234567.0);
+        writer.Attribute("type", "a&b <\"c\">");
+        writer.EndElement();
+        writer.StartElement("group");
+        writer.StartElement("item");
+        ASSERT_TRUE(writer.Close());
+    }
+
+    ASSERT_EQ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+              "<aqua><item x=\"100\" y=\"-0.125\" big=\"1234567\" type=\"a&amp;b &lt;&quot;c&quot;&gt;\"/>"
+              "<group><item/></group></aqua>\n", ReadFile(filename));
+
+    auto empty = TempPath(L"writer2.aqua");
+    {
+        AquaWriter writer(empty);
+        writer.StartElement("aqua");
+        writer.EndElement();
+    }
+
+    ASSERT_EQ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<aqua/>\n", ReadFile(empty));
+}
+
+TEST_F(AquaWriterTest, RoundTrip){
+    // Enough items to fill the buffer several times over
+    const int NumItems = 20000;
+
+    auto filename = TempPath(L"writer3.aqua");
+    {
+        AquaWriter writer(filename);
+        writer.StartElement("aqua");
+        for (int i = 0; i < NumItems; i++)
+        {
+            writer.StartElement("item");
+            writer.Attribute("x", i * 0.5);
+            writer.Attribute("type", "sparty");
+            writer.EndElement();
+        }
+        ASSERT_TRUE(writer.Close());
+    }
+
+    AquaReader reader(filename);
+    ASSERT_TRUE(reader.Next());
+    ASSERT_EQ("aqua", reader.GetName());
+
+    int count = 0;
+    while (reader.Next())
+    {
+        ASSERT_EQ("item", reader.GetName());
+        ASSERT_EQ(count * 0.5, reader.GetDouble("x", -1));
+        ASSERT_EQ("sparty", reader.GetAttribute("type"));
+        count++;
+    }
+
+    ASSERT_FALSE(reader.HasError());
+    ASSERT_EQ(NumItems, count);
+}
@@ -5,37 +5,25 @@
 
 #include <pch.h>
 #include "gtest/gtest.h"
+#include "TestFiles.h"
 #include <Aquarium.h>
 #include <FishBeta.h>
 #include <DecorCastle.h>
 #include <SpartyFish.h>
 #include <Fish.h>
 #include <StinkyFish.h>
+#include <AquaBinaryWriter.h>
 #include <regex>
 #include <string>
 #include <fstream>
 #include <streambuf>
 #include <wx/filename.h>
+#include <TankData.h>
 
 using namespace std;
 
 class AquariumTest : public ::testing::Test {
 protected:
-    /**
-    * Create a path to a place to put temporary files
-    */
-    wxString TempPath()
-    {
-        // Create a temporary filename we can use
-        auto path = wxFileName::GetTempDir() + L"/aquarium";
-        if(!wxFileName::DirExists(path))
-        {
-            wxFileName::Mkdir(path);
-        }
-
-        return path;
-    }
-
     /**
     * Read a file into a wstring and return it.
     * @param filename Name of the file to read
@@ -74,15 +62,15 @@ protected:
     {
         aquarium->GetRandom().seed(RandomSeed);
 
-        auto fish1 = make_shared<FishBeta>(aquarium);
+        auto fish1 = aquarium->Create<FishBeta>();
         aquarium->Add(fish1);
         fish1->SetLocation(100, 200);
 
-        auto fish2 = make_shared<FishBeta>(aquarium);
+        auto fish2 = aquarium->Create<FishBeta>();
         aquarium->Add(fish2);
         fish2->SetLocation(400, 400);
 
-        auto fish3 = make_shared<FishBeta>(aquarium);
+        auto fish3 = aquarium->Create<FishBeta>();
         aquarium->Add(fish3);
         fish3->SetLocation(600, 100);
     }
@@ -114,15 +102,15 @@ protected:
     {
         aquarium->GetRandom().seed(RandomSeed);
 
-        auto type1 = make_shared<DecorCastle>(aquarium);
+        auto type1 = aquarium->Create<DecorCastle>();
         aquarium->Add(type1);
         type1->SetLocation(200, 200);
 
-        auto type2 = make_shared<SpartyFish>(aquarium);
+        auto type2 = aquarium->Create<SpartyFish>();
         aquarium->Add(type2);
         type2->SetLocation(500, 400);
 
-        auto type3 = make_shared<StinkyFish>(aquarium);
+        auto type3 = aquarium->Create<StinkyFish>();
         aquarium->Add(type3);
         type3->SetLocation(600, 200);
     }
@@ -180,14 +168,14 @@ TEST_F(AquariumTest, HitTest) {
     ASSERT_EQ(aquarium.HitTest(100, 200), nullptr) <<
                                                    L"Testing empty aquarium";
 
-    shared_ptr<FishBeta> fish1 = make_shared<FishBeta>(&aquarium);
+    auto fish1 = aquarium.Create<FishBeta>();
     aquarium.Add(fish1);
     fish1->SetLocation(100, 200);
 
     ASSERT_TRUE(aquarium.HitTest(100, 200) == fish1) <<
                                                      L"Testing fish at 100, 200";
 
-    shared_ptr<FishBeta> fish2 = make_shared<FishBeta>(&aquarium);
+    auto fish2 = aquarium.Create<FishBeta>();
     aquarium.Add(fish2);
     fish2->SetLocation(100, 200);
 
@@ -198,9 +186,25 @@ TEST_F(AquariumTest, HitTest) {
                                                 L"Testing when no image";
 }
 
+TEST_F(AquariumTest, HitTestStatic) {
+    Aquarium aquarium;
+
+    auto fish = aquarium.Create<FishBeta>();
+    aquarium.Add(fish);
+    fish->SetLocation(300, 300);
+
+    // Decor is drawn behind every fish, even one added before it
+    auto castle = aquarium.Create<DecorCastle>();
+    aquarium.Add(castle);
+    castle->SetLocation(300, 300);
+    ASSERT_EQ(fish, aquarium.HitTest(300, 300));
+
+    fish->SetLocation(600, 100);
+    ASSERT_EQ(castle, aquarium.HitTest(300, 300));
+    ASSERT_EQ(fish, aquarium.HitTest(600, 100));
+}
+
 TEST_F(AquariumTest, Save) {
-    // Create a path to temporary files
-    auto path = TempPath();
 
     // Create an aquarium
     Aquarium aquarium;
@@ -208,7 +212,7 @@ TEST_F(AquariumTest, Save) {
     //
     // First test, saving an empty aquarium
     //
-    auto file1 = path + L"/test1.aqua";
+    auto file1 = TempPath(L"test1.aqua");
     aquarium.Save(file1);
 
      TestEmpty(file1);
@@ -219,7 +223,7 @@ TEST_F(AquariumTest, Save) {
 
     PopulateThreeBetas(&aquarium);
 
-    auto file2 = path + L"/test2.aqua";
+    auto file2 = TempPath(L"test2.aqua");
     aquarium.Save(file2);
 
     TestThreeBetas(file2);
@@ -230,7 +234,7 @@ TEST_F(AquariumTest, Save) {
     Aquarium aquarium3;
     PopulateAllTypes(&aquarium3);
 
-    auto file3 = path + L"/test3.aqua";
+    auto file3 = TempPath(L"test3.aqua");
     aquarium3.Save(file3);
 
     TestAllTypes(file3);
@@ -241,23 +245,149 @@ TEST_F(AquariumTest, Save) {
 
 }
 
+TEST_F(AquariumTest, Binary) {
+
+    Aquarium aquarium;
+    PopulateAllTypes(&aquarium);
+
+    // A binary file loads back to the same items in the same order
+    auto file1 = TempPath(L"test5.aquab");
+    aquarium.SaveBinary(file1);
+
+    Aquarium aquarium2;
+    aquarium2.Load(file1);
+
+    auto file2 = TempPath(L"test5.aqua");
+    aquarium2.Save(file2);
+    TestAllTypes(file2);
+
+    // So does an empty one
+    Aquarium aquarium3;
+    aquarium3.SaveBinary(file1);
+    aquarium2.Load(file1);
+    aquarium2.Save(file2);
+    TestEmpty(file2);
+
+    // A record with an unknown species index fails the
+    // load and leaves the aquarium as it was
+    auto file3 = TempPath(L"test6.aquab");
+    {
+        AquaBinaryWriter writer(file3, {"beta"}, 2);
+        AquaBinaryRecord record;
+        writer.Add(record);
+        record.species = 1;
+        writer.Add(record);
+        ASSERT_TRUE(writer.Close());
+    }
+
+    ASSERT_FALSE(aquarium.Load(file3));
+    aquarium.Save(file2);
+    TestAllTypes(file2);
+}
+
+TEST_F(AquariumTest, SwapItems) {
+    Aquarium aquarium;
+    PopulateThreeBetas(&aquarium);
+
+    Aquarium loaded;
+    PopulateAllTypes(&loaded);
+
+    aquarium.SwapItems(loaded);
+
+    // Each aquarium has the other's items, and they know it
+    auto castle = aquarium.HitTest(200, 200);
+    ASSERT_NE(nullptr, castle);
+    ASSERT_EQ(&aquarium, castle->GetAquarium());
+    ASSERT_EQ(&aquarium.GetKinematics(), castle->GetKinematics());
+    ASSERT_EQ(3, aquarium.GetKinematics().GetActiveCount());
+
+    auto beta = loaded.HitTest(400, 400);
+    ASSERT_NE(nullptr, beta);
+    ASSERT_EQ(&loaded, beta->GetAquarium());
+
+    // Moving an item updates the aquarium it is now in
+    castle->SetLocation(800, 300);
+    ASSERT_EQ(castle, aquarium.HitTest(800, 300));
+    ASSERT_EQ(nullptr, loaded.HitTest(800, 300));
+
+    auto file1 = TempPath(L"test6.aqua");
+    loaded.Save(file1);
+    TestThreeBetas(file1);
+}
+
+TEST_F(AquariumTest, SetTankData) {
+    // Castles scattered among the fish, so the
+    // animated slots have to be moved in front
+    TankData data;
+    data.species.push_back(TankSpecies{"castle", false});
+    data.species.push_back(TankSpecies{"beta", true});
+    for (int i = 0; i < 200; i++)
+    {
+        AquaBinaryRecord record;
+        record.x = 100 + i * 3;
+        record.y = 100 + (i % 50) * 10;
+        record.species = i % 5 == 0 ? 0 : 1;
+        if (record.species == 1)
+        {
+            record.speedX = i;
+            record.speedY = -i;
+        }
+
+        data.items.push_back(record);
+    }
+
+    Aquarium aquarium;
+    ASSERT_TRUE(aquarium.SetTankData(data));
+    ASSERT_EQ(200, aquarium.GetKinematics().GetActiveCount());
+    ASSERT_EQ(160, aquarium.GetKinematics().GetAnimatedCount());
+
+    // Each item is in the grid at its own location
+    for (auto &record : data.items)
+    {
+        auto near = aquarium.ItemsNear(record.x, record.y, 0.5);
+        ASSERT_EQ(1, near.size());
+        ASSERT_EQ(record.species == 1, near[0]->IsAnimated());
+        ASSERT_EQ(record.x, near[0]->GetX());
+        ASSERT_EQ(record.y, near[0]->GetY());
+    }
+
+    // The castles come back first, then the fish, each
+    // in the order they were in the data
+    TankData saved;
+    aquarium.GetTankData(saved);
+    ASSERT_EQ(200, saved.items.size());
+    size_t next = 0;
+    for (auto type : {"castle", "beta"})
+    {
+        for (auto &record : data.items)
+        {
+            if (data.species[record.species].type == type)
+            {
+                auto &item = saved.items[next++];
+                ASSERT_EQ(type, saved.species[item.species].type);
+                ASSERT_EQ(record.x, item.x);
+                ASSERT_EQ(record.y, item.y);
+                ASSERT_EQ(record.speedX, item.speedX);
+                ASSERT_EQ(record.speedY, item.speedY);
+            }
+        }
+    }
+}
+
 TEST_F(AquariumTest, Clear)
 {
-    auto path = TempPath();
 
     Aquarium aquarium5;
     PopulateAllTypes(&aquarium5);
     aquarium5.Clear();
 
-    auto file3 = path + L"/test4.aqua";
+    auto file3 = TempPath(L"test4.aqua");
     aquarium5.Save(file3);
 
     TestClearAllTypes(file3);
 }
 
 TEST_F(AquariumTest, Load) {
-    // Create a path to temporary files
-    auto path = TempPath();
 
     // Create an aquarium
     Aquarium aquarium;
@@ -266,7 +396,7 @@ TEST_F(AquariumTest, Load) {
     //
     // First test, saving an empty aquarium
     //
-    auto file1 = path + L"/test1.aqua";
+    auto file1 = TempPath(L"test1.aqua");
     aquarium.Save(file1);
 
     TestEmpty(file1);
@@ -281,7 +411,7 @@ TEST_F(AquariumTest, Load) {
 
     PopulateThreeBetas(&aquarium);
 
-    auto file2 = path + L"/test2.aqua";
+    auto file2 = TempPath(L"test2.aqua");
     aquarium.Save(file2);
 
     TestThreeBetas(file2);
@@ -297,7 +427,7 @@ TEST_F(AquariumTest, Load) {
     aquarium3.GetRandom().seed(RandomSeed);
     PopulateAllTypes(&aquarium3);
 
-    auto file3 = path + L"/test3.aqua";
+    auto file3 = TempPath(L"test3.aqua");
     aquarium3.Save(file3);
 
     TestAllTypes(file3);
@@ -311,7 +441,7 @@ TEST_F(AquariumTest, Load) {
 TEST_F(AquariumTest, NonoverlappingAdd1) {
     Aquarium aquarium;
 
-    shared_ptr<FishBeta> fish1 = make_shared<FishBeta>(&aquarium);
+    auto fish1 = aquarium.Create<FishBeta>();
     aquarium.Add(fish1);
 
     ASSERT_NEAR(200, fish1->GetX(), 0.1);
@@ -320,7 +450,7 @@ TEST_F(AquariumTest, NonoverlappingAdd1) {
     // First fish moved to 210, 210
     fish1->SetLocation(210, 210);
 
-    shared_ptr<FishBeta> fish2 = make_shared<FishBeta>(&aquarium);
+    auto fish2 = aquarium.Create<FishBeta>();
     aquarium.Add(fish2);
 
     // Second fish should be created at 200, 200, since there
@@ -328,7 +458,7 @@ TEST_F(AquariumTest, NonoverlappingAdd1) {
     ASSERT_NEAR(200, fish2->GetX(), 0.1);
     ASSERT_NEAR(200, fish2->GetY(), 0.1);
 
-    shared_ptr<FishBeta> fish3 = make_shared<FishBeta>(&aquarium);
+    auto fish3 = aquarium.Create<FishBeta>();
     aquarium.Add(fish3);
 
     // Since there are fish at (200, 200) and (210, 210),
@@ -340,13 +470,13 @@ TEST_F(AquariumTest, NonoverlappingAdd1) {
 TEST_F(AquariumTest, NonoverlappingAdd2) {
     Aquarium aquarium;
 
-    shared_ptr<FishBeta> fish1 = make_shared<FishBeta>(&aquarium);
+    auto fish1 = aquarium.Create<FishBeta>();
     aquarium.Add(fish1);
 
     ASSERT_NEAR(200, fish1->GetX(), 0.1);
     ASSERT_NEAR(200, fish1->GetY(), 0.1);
 
-    shared_ptr<FishBeta> fish2 = make_shared<FishBeta>(&aquarium);
+    auto fish2 = aquarium.Create<FishBeta>();
     aquarium.Add(fish2);
 
     ASSERT_NEAR(210, fish2->GetX(), 0.1);
@@ -355,7 +485,7 @@ TEST_F(AquariumTest, NonoverlappingAdd2) {
     fish1->SetLocation(220, 220);
     // Fish are now at (220, 220), (210, 210)
 
-    shared_ptr<FishBeta> fish3 = make_shared<FishBeta>(&aquarium);
+    auto fish3 = aquarium.Create<FishBeta>();
     aquarium.Add(fish3);
 
     // Since nothing is at (200, 200), the fish should be created there
@@ -365,10 +495,131 @@ TEST_F(AquariumTest, NonoverlappingAdd2) {
     fish2->SetLocation(230, 230);
     // Fish are now at (220, 220), (230, 230), (200, 200)
 
-    shared_ptr<FishBeta> fish4 = make_shared<FishBeta>(&aquarium);
+    auto fish4 = aquarium.Create<FishBeta>();
     aquarium.Add(fish4);
 
     // No fish at 210, 210, so should be created there.
     ASSERT_NEAR(210, fish4->GetX(), 0.1);
     ASSERT_NEAR(210, fish4->GetY(), 0.1);
 }
+
+TEST_F(AquariumTest, StaticLayer) {
+    Aquarium aquarium;
+    ASSERT_TRUE(aquarium.IsStaticLayerDirty());
+    aquarium.UpdateStaticLayer();
+    ASSERT_FALSE(aquarium.IsStaticLayerDirty());
+
+    // Fish are not on the static layer, so nothing they do redraws it
+    auto fish = aquarium.Create<FishBeta>();
+    aquarium.Add(fish);
+    fish->SetLocation(300, 300);
+    fish->SetMirror(true);
+    aquarium.Update(0.1);
+    aquarium.SendToBack(fish);
+    ASSERT_FALSE(aquarium.IsStaticLayerDirty());
+
+    // Adding, dragging or reordering decor does
+    auto castle = aquarium.Create<DecorCastle>();
+    aquarium.Add(castle);
+    ASSERT_TRUE(aquarium.IsStaticLayerDirty());
+    aquarium.UpdateStaticLayer();
+
+    aquarium.Update(0.1);
+    ASSERT_FALSE(aquarium.IsStaticLayerDirty());
+
+    castle->SetLocation(500, 500);
+    ASSERT_TRUE(aquarium.IsStaticLayerDirty());
+    aquarium.UpdateStaticLayer();
+
+    auto castle2 = aquarium.Create<DecorCastle>();
+    aquarium.Add(castle2);
+    aquarium.UpdateStaticLayer();
+    aquarium.SendToFront(castle);
+    ASSERT_TRUE(aquarium.IsStaticLayerDirty());
+    aquarium.UpdateStaticLayer();
+
+    aquarium.Clear();
+    ASSERT_TRUE(aquarium.IsStaticLayerDirty());
+}
+
+TEST_F(AquariumTest, Damage) {
+    Aquarium aquarium;
+    vector<wxRect> rects;
+
+    // A new aquarium needs to be drawn completely
+    ASSERT_TRUE(aquarium.TakeDamage(rects));
+    ASSERT_FALSE(aquarium.TakeDamage(rects));
+    ASSERT_TRUE(rects.empty());
+
+    auto fish = aquarium.Create<FishBeta>();
+    aquarium.Add(fish);
+    aquarium.TakeDamage(rects);
+
+    // Moving a fish damages where it was and where it is now
+    fish->SetLocation(220, 200);
+    ASSERT_FALSE(aquarium.TakeDamage(rects));
+    ASSERT_EQ(1, rects.size());
+    ASSERT_TRUE(rects[0].Contains(200 - 125/2, 200 - 117/2));
+    ASSERT_TRUE(rects[0].Contains(220 + 125/2, 200 + 117/2));
+    ASSERT_FALSE(rects[0].Contains(400, 400));
+
+    // Turning around damages the fish
+    fish->SetMirror(true);
+    ASSERT_FALSE(aquarium.TakeDamage(rects));
+    ASSERT_EQ(1, rects.size());
+
+    // Nothing changed
+    ASSERT_FALSE(aquarium.TakeDamage(rects));
+    ASSERT_TRUE(rects.empty());
+
+    // A fish that turns at the wall in a step too small to
+    // move its rectangle still damages the fish
+    double wall = aquarium.GetWidth() - 10 - 125 / 2.0;
+    fish->SetMirror(false);
+    fish->SetLocation(wall - 0.01, 200);
+    fish->SetSpeed(20, 0);
+    aquarium.TakeDamage(rects);
+    aquarium.Advance(1.0 / 120);
+    ASSERT_TRUE(fish->GetMirror());
+    ASSERT_FALSE(aquarium.TakeDamage(rects));
+    ASSERT_EQ(1, rects.size());
+    ASSERT_TRUE(rects[0].Contains(int(wall), 200));
+
+    aquarium.Clear();
+    ASSERT_TRUE(aquarium.TakeDamage(rects));
+}
+
+TEST_F(AquariumTest, DamageTiles) {
+    // Too many fish to track one rectangle for each,
+    // all swimming in one corner of the aquarium
+    TankData data;
+    data.species.push_back(TankSpecies{"beta", true});
+    for (int i = 0; i < 100; i++)
+    {
+        AquaBinaryRecord record;
+        record.x = 300 + i % 10;
+        record.y = 300 + i / 10;
+        record.species = 0;
+        record.speedX = 10;
+        data.items.push_back(record);
+    }
+
+    Aquarium aquarium;
+    ASSERT_TRUE(aquarium.SetTankData(data));
+    vector<wxRect> rects;
+    aquarium.TakeDamage(rects);
+
+    // Only the tiles around the fish are damaged
+    aquarium.Update(0.1);
+    ASSERT_FALSE(aquarium.TakeDamage(rects));
+    ASSERT_FALSE(rects.empty());
+    bool covered = false;
+    for (const auto &rect : rects)
+    {
+        covered = covered || rect.Contains(300, 300);
+        ASSERT_FALSE(rect.Contains(700, 600));
+        ASSERT_TRUE(wxRect(100, 100, 400, 400).Contains(rect));
+    }
+
+    ASSERT_TRUE(covered);
+}
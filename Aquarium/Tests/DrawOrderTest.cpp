@@ -0,0 +1,212 @@
+/**
+ * @file DrawOrderTest.cpp
+ * @author joeyv
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <DrawOrder.h>
+#include <Aquarium.h>
+#include <FishBeta.h>
+
+#include <random>
+
+using namespace std;
+
+/**
+ * Get the items of a draw order from back to front
+ * @param order The draw order
+ * @return Vector of the items
+ */
+static vector<Item *> Items(const DrawOrder &order)
+{
+    vector<Item *> items;
+    for (auto item : order)
+    {
+        items.push_back(item);
+    }
+
+    return items;
+}
+
+TEST(DrawOrderTest, Moves){
+    Aquarium aquarium;
+    auto a = aquarium.Create<FishBeta>();
+    auto b = aquarium.Create<FishBeta>();
+    auto c = aquarium.Create<FishBeta>();
+    auto d = aquarium.Create<FishBeta>();
+
+    DrawOrder order;
+    order.PushFront(a);
+    order.PushFront(b);
+    order.PushFront(c);
+    ASSERT_EQ(vector<Item *>({a, b, c}), Items(order));
+    ASSERT_FALSE(order.Contains(d));
+    ASSERT_FALSE(order.SendToFront(d));
+
+    ASSERT_TRUE(order.SendToFront(a));
+    ASSERT_EQ(vector<Item *>({b, c, a}), Items(order));
+
+    ASSERT_TRUE(order.SendToBack(a));
+    ASSERT_EQ(vector<Item *>({a, b, c}), Items(order));
+
+    // Raising and lowering step over the tombstones
+    ASSERT_TRUE(order.Raise(a));
+    ASSERT_EQ(vector<Item *>({b, a, c}), Items(order));
+    ASSERT_TRUE(order.Lower(c));
+    ASSERT_EQ(vector<Item *>({b, c, a}), Items(order));
+    ASSERT_FALSE(order.Raise(a));
+    ASSERT_FALSE(order.Lower(b));
+
+    // Keys always increase from back to front
+    ASSERT_LT(b->GetZOrder(), c->GetZOrder());
+    ASSERT_LT(c->GetZOrder(), a->GetZOrder());
+    ASSERT_EQ(3u, order.GetCount());
+}
+
+TEST(DrawOrderTest, Compact){
+    Aquarium aquarium;
+    vector<FishBeta*> fishes;
+    DrawOrder order;
+    for (int i = 0; i < 10; i++)
+    {
+        fishes.push_back(aquarium.Create<FishBeta>());
+        order.PushFront(fishes.back());
+    }
+
+    // Enough moves to squeeze out the tombstones many times
+    for (int i = 0; i < 1000; i++)
+    {
+        ASSERT_TRUE(order.SendToFront(fishes[i % 10]));
+    }
+
+    ASSERT_EQ(10u, order.GetCount());
+    auto items = Items(order);
+    for (int i = 0; i < 10; i++)
+    {
+        ASSERT_EQ(fishes[i], items[i]);
+        ASSERT_TRUE(order.Contains(items[i]));
+    }
+}
+
+TEST(DrawOrderTest, TombstoneRun){
+    const int NumMoved = 1000;
+
+    Aquarium aquarium;
+    DrawOrder order;
+    auto a = aquarium.Create<FishBeta>();
+    order.PushFront(a);
+    vector<Item *> moved;
+    for (int i = 0; i < NumMoved; i++)
+    {
+        moved.push_back(aquarium.Create<FishBeta>());
+        order.PushFront(moved.back());
+    }
+    auto b = aquarium.Create<FishBeta>();
+    order.PushFront(b);
+
+    // Leaves a long run of tombstones between a and b,
+    // but not enough of them to be squeezed out
+    for (auto item : moved)
+    {
+        ASSERT_TRUE(order.SendToFront(item));
+    }
+
+    ASSERT_TRUE(order.Raise(a));
+    ASSERT_EQ(b, Items(order)[0]);
+    ASSERT_EQ(a, Items(order)[1]);
+    ASSERT_TRUE(order.Lower(a));
+    ASSERT_EQ(a, Items(order)[0]);
+    ASSERT_FALSE(order.Lower(a));
+
+    // Sending b to the front grows the run, and raising and
+    // lowering a crosses it each time
+    for (int i = 0; i < NumMoved; i++)
+    {
+        ASSERT_TRUE(order.SendToFront(b));
+        ASSERT_TRUE(order.Raise(a));
+        ASSERT_EQ(moved[0], Items(order)[0]);
+        ASSERT_EQ(a, Items(order)[1]);
+        ASSERT_TRUE(order.Lower(a));
+        ASSERT_EQ(a, Items(order)[0]);
+    }
+
+    auto items = Items(order);
+    ASSERT_EQ(NumMoved + 2u, items.size());
+    ASSERT_EQ(b, items.back());
+}
+
+TEST(DrawOrderTest, MatchesVector){
+    const int NumItems = 50;
+    const int NumMoves = 20000;
+
+    Aquarium aquarium;
+    DrawOrder order;
+    vector<Item *> expected;
+    for (int i = 0; i < NumItems; i++)
+    {
+        expected.push_back(aquarium.Create<FishBeta>());
+        order.PushFront(expected.back());
+    }
+
+    std::mt19937 random(1234);
+    std::uniform_int_distribution<int> pick(0, NumItems - 1);
+    std::uniform_int_distribution<int> operation(0, 3);
+    for (int i = 0; i < NumMoves; i++)
+    {
+        auto index = pick(random);
+        auto item = expected[index];
+        switch (operation(random))
+        {
+        case 0:
+            order.SendToFront(item);
+            expected.erase(expected.begin() + index);
+            expected.push_back(item);
+            break;
+
+        case 1:
+            order.SendToBack(item);
+            expected.erase(expected.begin() + index);
+            expected.insert(expected.begin(), item);
+            break;
+
+        case 2:
+            ASSERT_EQ(index < NumItems - 1, order.Raise(item));
+            if (index < NumItems - 1)
+            {
+                swap(expected[index], expected[index + 1]);
+            }
+            break;
+
+        default:
+            ASSERT_EQ(index > 0, order.Lower(item));
+            if (index > 0)
+            {
+                swap(expected[index], expected[index - 1]);
+            }
+            break;
+        }
+
+        ASSERT_EQ(expected, Items(order));
+    }
+}
+
+TEST(DrawOrderTest, HitTestFront){
+    Aquarium aquarium;
+    auto fish1 = aquarium.Create<FishBeta>();
+    auto fish2 = aquarium.Create<FishBeta>();
+    aquarium.Add(fish1);
+    aquarium.Add(fish2);
+    fish1->SetLocation(400, 400);
+    fish2->SetLocation(400, 400);
+
+    ASSERT_EQ(fish2, aquarium.HitTest(400, 400));
+    aquarium.SendToBack(fish2);
+    ASSERT_EQ(fish1, aquarium.HitTest(400, 400));
+    aquarium.Raise(fish2);
+    ASSERT_EQ(fish2, aquarium.HitTest(400, 400));
+    aquarium.Lower(fish2);
+    ASSERT_EQ(fish1, aquarium.HitTest(400, 400));
+    aquarium.SendToFront(fish2);
+    ASSERT_EQ(fish2, aquarium.HitTest(400, 400));
+}
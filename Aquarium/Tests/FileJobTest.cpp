@@ -0,0 +1,139 @@
+/**
+ * @file FileJobTest.cpp
+ * @author joeyv
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include "TestFiles.h"
+#include <FileJob.h>
+#include <Aquarium.h>
+#include <wx/filename.h>
+
+using namespace std;
+
+class FileJobTest : public ::testing::Test {
+protected:
+    /**
+     * Make tank data with a number of items
+     * @param count Number of items
+     * @return Tank data
+     */
+    TankData MakeData(int count)
+    {
+        TankData data;
+        data.species.push_back(TankSpecies{"beta", true});
+        data.species.push_back(TankSpecies{"castle", false});
+        for (int i = 0; i < count; i++)
+        {
+            AquaBinaryRecord record;
+            record.x = i;
+            record.y = i * 2;
+            record.speedX = i % 2 == 0 ? 10 : 0;
+            record.species = i % 2;
+            data.items.push_back(record);
+        }
+
+        return data;
+    }
+};
+
+TEST_F(FileJobTest, SaveAndLoad){
+    auto filename = TempPath(L"job1.aqua");
+
+    FileJob save(filename, MakeData(3), TankFile::Format::Xml);
+    ASSERT_FALSE(save.IsLoad());
+    save.Wait();
+    ASSERT_TRUE(save.IsDone());
+    ASSERT_TRUE(save.Succeeded());
+    ASSERT_EQ(1, save.GetProgress());
+
+    ASSERT_EQ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<aqua>"
+              "<item x=\"0\" y=\"0\" x-speed=\"10\" y-speed=\"0\" type=\"beta\"/>"
+              "<item x=\"1\" y=\"2\" type=\"castle\"/>"
+              "<item x=\"2\" y=\"4\" x-speed=\"10\" y-speed=\"0\" type=\"beta\"/>"
+              "</aqua>\n", ReadFile(filename));
+
+    FileJob load(filename);
+    ASSERT_TRUE(load.IsLoad());
+    load.Wait();
+    ASSERT_TRUE(load.Succeeded());
+
+    auto &data = load.GetData();
+    ASSERT_EQ(2, data.species.size());
+    ASSERT_EQ("beta", data.species[0].type);
+    ASSERT_TRUE(data.species[0].moving);
+    ASSERT_EQ("castle", data.species[1].type);
+    ASSERT_FALSE(data.species[1].moving);
+    ASSERT_EQ(3, data.items.size());
+    ASSERT_EQ(2, data.items[2].x);
+    ASSERT_EQ(4, data.items[2].y);
+    ASSERT_EQ(10, data.items[2].speedX);
+    ASSERT_EQ(0, data.items[2].species);
+
+    // A file that is not there fails
+    FileJob missing(TempPath(L"missing.aqua"));
+    missing.Wait();
+    ASSERT_TRUE(missing.IsDone());
+    ASSERT_FALSE(missing.Succeeded());
+    ASSERT_FALSE(missing.IsCancelled());
+}
+
+TEST_F(FileJobTest, BuildAquarium){
+    auto filename = TempPath(L"job3.aquab");
+
+    FileJob save(filename, MakeData(1001), TankFile::Format::Binary);
+    save.Wait();
+    ASSERT_TRUE(save.Succeeded());
+
+    // The items are built on the job thread
+    FileJob load(filename, make_unique<Aquarium>());
+    load.Wait();
+    ASSERT_TRUE(load.Succeeded());
+    ASSERT_EQ(1, load.GetProgress());
+    ASSERT_TRUE(load.GetData().items.empty());
+
+    auto loaded = load.TakeAquarium();
+    ASSERT_NE(nullptr, loaded);
+    auto &kinematics = loaded->GetKinematics();
+    ASSERT_EQ(1001, kinematics.GetActiveCount());
+    ASSERT_EQ(501, kinematics.GetAnimatedCount());
+
+    // And can be swapped into an aquarium on this thread
+    Aquarium aquarium;
+    aquarium.SwapItems(*loaded);
+    TankData data;
+    aquarium.GetTankData(data);
+    ASSERT_EQ(1001, data.items.size());
+
+    // The 500 castles come first, then the fish
+    ASSERT_EQ(0, data.items[500].x);
+    ASSERT_EQ(1000, data.items[1000].x);
+}
+
+TEST_F(FileJobTest, Cancel){
+    auto filename = TempPath(L"job2.aquab");
+
+    FileJob save(filename, MakeData(10), TankFile::Format::Binary);
+    save.Wait();
+    ASSERT_TRUE(save.Succeeded());
+    auto saved = ReadFile(filename);
+
+    // A cancelled save leaves the file that was there
+    FileJob cancelled(filename, MakeData(1000000), TankFile::Format::Binary);
+    cancelled.Cancel();
+    cancelled.Wait();
+    ASSERT_TRUE(cancelled.IsDone());
+    ASSERT_TRUE(cancelled.IsCancelled());
+    ASSERT_FALSE(cancelled.Succeeded());
+    ASSERT_EQ(saved, ReadFile(filename));
+    ASSERT_FALSE(wxFileName::FileExists(filename + L".part"));
+
+    // Destroying a job cancels it
+    {
+        FileJob load(filename);
+    }
+    {
+        FileJob load(filename, make_unique<Aquarium>());
+    }
+}
@@ -0,0 +1,109 @@
+/**
+ * @file ImageCacheTest.cpp
+ * @author joeyv
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include "TestFiles.h"
+#include <ImageCache.h>
+#include <wx/filename.h>
+#include <wx/filefn.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+using namespace std;
+
+class ImageCacheTest : public ::testing::Test {
+protected:
+    /**
+     * Are two images the same, pixel for pixel?
+     * @param a First image
+     * @param b Second image
+     * @return true if they are the same
+     */
+    bool Same(const wxImage &a, const wxImage &b)
+    {
+        if (!a.IsOk() || !b.IsOk() || a.GetWidth() != b.GetWidth() ||
+                a.GetHeight() != b.GetHeight() || a.HasAlpha() != b.HasAlpha() ||
+                a.HasMask() != b.HasMask())
+        {
+            return false;
+        }
+
+        if (a.HasMask() && (a.GetMaskRed() != b.GetMaskRed() ||
+                a.GetMaskGreen() != b.GetMaskGreen() || a.GetMaskBlue() != b.GetMaskBlue()))
+        {
+            return false;
+        }
+
+        size_t pixels = (size_t)a.GetWidth() * a.GetHeight();
+        return memcmp(a.GetData(), b.GetData(), pixels * 3) == 0 &&
+                (!a.HasAlpha() || memcmp(a.GetAlpha(), b.GetAlpha(), pixels) == 0);
+    }
+};
+
+TEST_F(ImageCacheTest, Load){
+    auto directory = TempPath(L"imagecache").ToStdWstring();
+    auto source = TempPath(L"imagecache-source.png").ToStdWstring();
+    auto path = ImageCache::GetCachePath(directory, source);
+    wxRemoveFile(path);
+
+    filesystem::copy_file("images/beta.png", filesystem::path(source), filesystem::copy_options::overwrite_existing);
+    auto modified = filesystem::last_write_time(filesystem::path(source));
+    wxImage beta(L"images/beta.png", wxBITMAP_TYPE_ANY);
+    wxImage castle(L"images/castle.png", wxBITMAP_TYPE_ANY);
+
+    // The first load decodes the image and writes the cache
+    ASSERT_TRUE(Same(beta, ImageCache::Load(directory, source)));
+    ASSERT_TRUE(wxFileName::FileExists(path));
+    ASSERT_TRUE(Same(beta, ImageCache::Load(directory, source)));
+
+    // With the same time the image file is not even read, so
+    // replacing it without changing the time is not noticed
+    filesystem::copy_file("images/castle.png", filesystem::path(source), filesystem::copy_options::overwrite_existing);
+    filesystem::last_write_time(filesystem::path(source), modified);
+    ASSERT_TRUE(Same(beta, ImageCache::Load(directory, source)));
+
+    // A new time makes the cache check the contents
+    filesystem::last_write_time(filesystem::path(source), modified + chrono::hours(1));
+    ASSERT_TRUE(Same(castle, ImageCache::Load(directory, source)));
+
+    // Only the time changing keeps the cached image
+    filesystem::last_write_time(filesystem::path(source), modified + chrono::hours(2));
+    ASSERT_TRUE(Same(castle, ImageCache::Load(directory, source)));
+
+    // A damaged cache file is replaced
+    {
+        ofstream damaged(filesystem::path(path), ios::binary | ios::trunc);
+        damaged << "AQUAIMG";
+    }
+    ASSERT_TRUE(Same(castle, ImageCache::Load(directory, source)));
+    ASSERT_TRUE(Same(castle, ImageCache::Load(directory, source)));
+
+    // Images that do not exist are not cached
+    ASSERT_FALSE(ImageCache::Load(directory, TempPath(L"imagecache-missing.png").ToStdWstring()).IsOk());
+}
+
+TEST_F(ImageCacheTest, Mask){
+    auto directory = TempPath(L"imagecache").ToStdWstring();
+    auto source = TempPath(L"imagecache-limpet.png").ToStdWstring();
+    wxRemoveFile(ImageCache::GetCachePath(directory, source));
+
+    // The limpet's transparency loads as a mask colour, which
+    // must come back from the cache as well as the pixels
+    filesystem::copy_file("images/limpet.png", filesystem::path(source), filesystem::copy_options::overwrite_existing);
+    wxImage limpet(L"images/limpet.png", wxBITMAP_TYPE_ANY);
+    ASSERT_TRUE(limpet.HasMask());
+
+    ASSERT_TRUE(Same(limpet, ImageCache::Load(directory, source)));
+    ASSERT_TRUE(Same(limpet, ImageCache::Load(directory, source)));
+}
+
+TEST_F(ImageCacheTest, CachePath){
+    auto beta = ImageCache::GetCachePath(L"cache", L"images/beta.png");
+    ASSERT_EQ(beta, ImageCache::GetCachePath(L"cache", L"images/beta.png"));
+    ASSERT_NE(beta, ImageCache::GetCachePath(L"cache", L"images/castle.png"));
+    ASSERT_EQ(0u, beta.find(L"cache/"));
+}
@@ -0,0 +1,49 @@
+/**
+ * @file ImagePreloaderTest.cpp
+ * @author joeyv
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <ImagePreloader.h>
+#include <Aquarium.h>
+#include <cstring>
+
+using namespace std;
+
+TEST(ImagePreloaderTest, Get){
+    auto &preloader = ImagePreloader::Instance();
+
+    auto files = Aquarium::GetImageFiles();
+    ASSERT_EQ(L"images/background1.png", files[0]);
+    files.push_back(L"images/missing.png");
+
+    preloader.Start(files);
+    ASSERT_TRUE(preloader.IsStarted());
+
+    // The preloaded images are the same as ones read directly
+    for (size_t i = 0; i + 1 < files.size(); i++)
+    {
+        wxImage direct(files[i], wxBITMAP_TYPE_ANY);
+        auto image = preloader.Get(files[i]);
+        ASSERT_TRUE(image.IsOk());
+        ASSERT_EQ(direct.GetWidth(), image.GetWidth());
+        ASSERT_EQ(direct.GetHeight(), image.GetHeight());
+        ASSERT_EQ(direct.HasAlpha(), image.HasAlpha());
+        size_t pixels = (size_t)image.GetWidth() * image.GetHeight();
+        ASSERT_EQ(0, memcmp(direct.GetData(), image.GetData(), pixels * 3));
+
+        // Asking again gives the same image
+        ASSERT_TRUE(preloader.Get(files[i]).IsSameAs(image));
+    }
+
+    preloader.Wait();
+    ASSERT_FALSE(preloader.Get(L"images/missing.png").IsOk());
+
+    // Images that were not preloaded are still available
+    ASSERT_TRUE(preloader.Get(L"images/limpet.png").IsOk());
+
+    // Starting again does not replace the images
+    preloader.Start({L"images/limpet.png"});
+    ASSERT_TRUE(preloader.Get(L"images/beta.png").IsOk());
+}
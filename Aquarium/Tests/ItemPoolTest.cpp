@@ -0,0 +1,157 @@
+/**
+ * @file ItemPoolTest.cpp
+ * @author joeyv
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <ItemPool.h>
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <DecorCastle.h>
+
+#include <cstdint>
+#include <set>
+
+using namespace std;
+
+/// Number of times CountDestroy has been called
+static int destroyed = 0;
+
+/**
+ * Destroy function that only counts its calls
+ * @param item Item to destroy
+ */
+static void CountDestroy(void *item)
+{
+    destroyed++;
+}
+
+/** Item that owns memory its destructor frees */
+class OwningItemMock : public Item {
+public:
+    /// Memory shared with the test
+    shared_ptr<int> mShared;
+
+    OwningItemMock(Aquarium *aquarium) : Item(aquarium, L"images/beta.png") {}
+};
+
+/** Item that says it can be freed without being destroyed */
+class ReleasableItemMock : public Item {
+public:
+    ReleasableItemMock(Aquarium *aquarium) : Item(aquarium, L"images/beta.png") {}
+
+    ~ReleasableItemMock() override { destroyed++; }
+};
+
+/// ReleasableItemMock is freed without running its destructor
+AQUARIUM_POOL_RELEASABLE(ReleasableItemMock);
+
+TEST(ItemPoolTest, Slabs){
+    ItemPool pool(100);
+    ASSERT_EQ(0, pool.GetSlabCount());
+
+    auto blocks = pool.GetSlabBlocks();
+    ASSERT_LT(1, blocks);
+
+    // Blocks are distinct and aligned
+    set<void *> seen;
+    for (size_t i = 0; i < blocks; i++)
+    {
+        auto block = pool.Allocate();
+        ASSERT_EQ(0, reinterpret_cast<uintptr_t>(block) % alignof(max_align_t));
+        ASSERT_TRUE(seen.insert(block).second);
+    }
+    ASSERT_EQ(1, pool.GetSlabCount());
+
+    // The next block starts a new slab
+    pool.Allocate();
+    ASSERT_EQ(2, pool.GetSlabCount());
+
+    pool.Release();
+    ASSERT_EQ(0, pool.GetSlabCount());
+}
+
+TEST(ItemPoolTest, Destroy){
+    destroyed = 0;
+    {
+        ItemPool pool(100, CountDestroy);
+        auto blocks = pool.GetSlabBlocks();
+        for (size_t i = 0; i < blocks + 2; i++)
+        {
+            pool.Allocate();
+        }
+
+        // Every item in the full slab and the partial one
+        pool.Release();
+        ASSERT_EQ(blocks + 2, destroyed);
+
+        // Items are destroyed with the pool too
+        destroyed = 0;
+        pool.Allocate();
+        pool.Allocate();
+    }
+    ASSERT_EQ(2, destroyed);
+}
+
+TEST(ItemPoolTest, Destructors){
+    auto shared = make_shared<int>(0);
+    destroyed = 0;
+    {
+        Aquarium aquarium;
+        aquarium.Create<OwningItemMock>()->mShared = shared;
+        aquarium.Create<ReleasableItemMock>();
+        ASSERT_EQ(2, shared.use_count());
+
+        // Clear destroys items that are not releasable
+        aquarium.Clear();
+        ASSERT_EQ(1, shared.use_count());
+
+        // And so does destroying the aquarium
+        aquarium.Create<OwningItemMock>()->mShared = shared;
+        aquarium.Create<ReleasableItemMock>();
+        ASSERT_EQ(2, shared.use_count());
+    }
+    ASSERT_EQ(1, shared.use_count());
+
+    // Releasable items are never destroyed
+    ASSERT_EQ(0, destroyed);
+}
+
+TEST(ItemPoolTest, TypeId){
+    ASSERT_EQ(ItemPool::TypeId<FishBeta>(), ItemPool::TypeId<FishBeta>());
+    ASSERT_NE(ItemPool::TypeId<FishBeta>(), ItemPool::TypeId<DecorCastle>());
+}
+
+TEST(ItemPoolTest, Handles){
+    Aquarium aquarium;
+    ASSERT_EQ(nullptr, aquarium.Get(ItemHandle()));
+
+    auto fish = aquarium.Create<FishBeta>();
+    auto castle = aquarium.Create<DecorCastle>();
+    aquarium.Add(fish);
+    aquarium.Add(castle);
+
+    auto fishHandle = fish->GetHandle();
+    auto castleHandle = castle->GetHandle();
+    ASSERT_FALSE(fishHandle.IsNull());
+    ASSERT_NE(fishHandle, castleHandle);
+    ASSERT_EQ(fish, aquarium.Get(fishHandle));
+    ASSERT_EQ(castle, aquarium.Get(castleHandle));
+
+    // Handles go stale when the items are swapped away
+    Aquarium other;
+    other.SwapItems(aquarium);
+    ASSERT_EQ(nullptr, aquarium.Get(fishHandle));
+    ASSERT_EQ(fish, other.Get(fishHandle));
+
+    // And when the aquarium is cleared, even once the
+    // handle table has grown back over the same entries
+    other.Clear();
+    ASSERT_EQ(nullptr, other.Get(fishHandle));
+    auto fish2 = other.Create<FishBeta>();
+    other.Create<DecorCastle>();
+    ASSERT_EQ(nullptr, other.Get(fishHandle));
+    ASSERT_EQ(nullptr, other.Get(castleHandle));
+    ASSERT_EQ(fish2, other.Get(fish2->GetHandle()));
+}
@@ -22,7 +22,7 @@ public:
 
 TEST(ItemTest, GettersSetters){
     Aquarium aquarium;
-    ItemMock item(&aquarium);
+    ItemMock &item = *aquarium.Create<ItemMock>();
 
     // Test initial values
     ASSERT_NEAR(0, item.GetX(), 0.0001);
@@ -41,7 +41,7 @@ TEST(ItemTest, GettersSetters){
 TEST(FishBetaTest, HitTest) {
     // Create a fish to test
     Aquarium aquarium;
-    ItemMock fish(&aquarium);
+    ItemMock &fish = *aquarium.Create<ItemMock>();
 
     // Give it a location
     // Always make the numbers different, in case they are mixed up
@@ -64,4 +64,24 @@ TEST(FishBetaTest, HitTest) {
 
     // On a fish transparent pixel
     ASSERT_FALSE(fish.HitTest(100 - 125/2 + 17, 200 - 117/2 + 16));
-}
\ No newline at end of file
+}
+TEST(FishBetaTest, HitTestMirrored) {
+    Aquarium aquarium;
+    ItemMock &fish = *aquarium.Create<ItemMock>();
+    fish.SetLocation(100, 200);
+
+    // A pixel that is opaque facing right, but transparent
+    // once the fish turns around
+    int x = 100 - 125/2 + 29;
+    int y = 200 - 117/2 + 40;
+    ASSERT_TRUE(fish.HitTest(x, y));
+
+    fish.SetMirror(true);
+    ASSERT_FALSE(fish.HitTest(x, y));
+
+    // The same pixel reflected about the center of the fish
+    ASSERT_TRUE(fish.HitTest(100 - 125/2 + 125 - 1 - 29, y));
+
+    // Center of the fish is still a hit
+    ASSERT_TRUE(fish.HitTest(100, 200));
+}
@@ -0,0 +1,252 @@
+/**
+ * @file KinematicsTest.cpp
+ * @author joeyv
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Kinematics.h>
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <DecorCastle.h>
+
+using namespace std;
+
+TEST(KinematicsTest, Slots){
+    Aquarium aquarium;
+    auto &kinematics = aquarium.GetKinematics();
+
+    auto fish1 = aquarium.Create<FishBeta>();
+    auto fish2 = aquarium.Create<FishBeta>();
+    auto fish3 = aquarium.Create<FishBeta>();
+    ASSERT_EQ(3, kinematics.GetCount());
+    ASSERT_EQ(0, kinematics.GetActiveCount());
+
+    fish1->SetLocation(100, 200);
+    fish2->SetLocation(300, 400);
+    fish3->SetLocation(500, 600);
+
+    // Adding moves the slot to the front
+    aquarium.Add(fish3);
+    fish3->SetLocation(500, 600);
+    ASSERT_EQ(1, kinematics.GetActiveCount());
+    ASSERT_TRUE(kinematics.IsActive(fish3->GetSlot()));
+    ASSERT_FALSE(kinematics.IsActive(fish1->GetSlot()));
+
+    // Every item still finds its own location
+    ASSERT_NEAR(100, fish1->GetX(), 0.0001);
+    ASSERT_NEAR(400, fish2->GetY(), 0.0001);
+    ASSERT_NEAR(500, fish3->GetX(), 0.0001);
+    ASSERT_EQ(fish3, kinematics.Owner(fish3->GetSlot()));
+
+    // Clearing the aquarium frees every slot at once
+    aquarium.Clear();
+    ASSERT_EQ(0, kinematics.GetActiveCount());
+    ASSERT_EQ(0, kinematics.GetCount());
+}
+
+TEST(KinematicsTest, UpdateOnlyAdded){
+    Aquarium aquarium;
+
+    auto fish1 = aquarium.Create<FishBeta>();
+    aquarium.Add(fish1);
+    fish1->SetLocation(500, 400);
+    fish1->SetSpeed(10, -20);
+
+    auto castle = aquarium.Create<DecorCastle>();
+    aquarium.Add(castle);
+    castle->SetLocation(300, 300);
+
+    // Not in the aquarium, so it does not swim
+    auto fish2 = aquarium.Create<FishBeta>();
+    fish2->SetLocation(200, 200);
+    fish2->SetSpeed(10, 10);
+
+    aquarium.Update(0.5);
+
+    ASSERT_NEAR(505, fish1->GetX(), 0.0001);
+    ASSERT_NEAR(390, fish1->GetY(), 0.0001);
+    ASSERT_NEAR(300, castle->GetX(), 0.0001);
+    ASSERT_NEAR(300, castle->GetY(), 0.0001);
+    ASSERT_NEAR(200, fish2->GetX(), 0.0001);
+    ASSERT_NEAR(200, fish2->GetY(), 0.0001);
+}
+
+TEST(KinematicsTest, Partitions){
+    Aquarium aquarium;
+    auto &kinematics = aquarium.GetKinematics();
+
+    auto castle1 = aquarium.Create<DecorCastle>();
+    auto fish1 = aquarium.Create<FishBeta>();
+    auto castle2 = aquarium.Create<DecorCastle>();
+    auto fish2 = aquarium.Create<FishBeta>();
+    for (Item *item : {(Item *)castle1, (Item *)fish1, (Item *)castle2, (Item *)fish2})
+    {
+        aquarium.Add(item);
+    }
+
+    // Animated slots are packed in front of the static ones
+    ASSERT_EQ(4, kinematics.GetActiveCount());
+    ASSERT_EQ(2, kinematics.GetAnimatedCount());
+    ASSERT_TRUE(kinematics.IsAnimated(fish1->GetSlot()));
+    ASSERT_TRUE(kinematics.IsAnimated(fish2->GetSlot()));
+    ASSERT_FALSE(kinematics.IsAnimated(castle1->GetSlot()));
+    ASSERT_TRUE(kinematics.IsActive(castle2->GetSlot()));
+    ASSERT_EQ(castle1, kinematics.Owner(castle1->GetSlot()));
+    ASSERT_EQ(fish2, kinematics.Owner(fish2->GetSlot()));
+
+    // A static item does not move, even given a speed
+    castle1->SetLocation(300, 300);
+    kinematics.SetSpeed(castle1->GetSlot(), 100, 100);
+    fish1->SetLocation(500, 400);
+    fish1->SetSpeed(10, 0);
+    aquarium.Update(0.5);
+    ASSERT_NEAR(300, castle1->GetX(), 0.0001);
+    ASSERT_NEAR(300, castle1->GetY(), 0.0001);
+    ASSERT_NEAR(505, fish1->GetX(), 0.0001);
+}
+
+TEST(KinematicsTest, KernelsMatchFishUpdate){
+    const int NumFish = 37;
+    const double Elapsed = 1.0 / 60;
+
+    for (auto kernel : {Kinematics::Kernel::Scalar, Kinematics::Kernel::SSE2, Kinematics::Kernel::AVX2})
+    {
+        if (!Kinematics::IsSupported(kernel))
+        {
+            continue;
+        }
+
+        // Each fish is in both aquariums, one updated a fish at
+        // a time by Fish::Update and one by the kernel
+        Aquarium reference;
+        Aquarium aquarium;
+        ASSERT_TRUE(aquarium.GetKinematics().SetKernel(kernel));
+
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<double> location(100, 700);
+        std::uniform_real_distribution<double> speed(-400, 400);
+
+        vector<FishBeta*> fishes1;
+        vector<FishBeta*> fishes2;
+        for (int i = 0; i < NumFish; i++)
+        {
+            double x = location(random), y = location(random);
+            double speedX = speed(random), speedY = speed(random);
+
+            auto fish1 = reference.Create<FishBeta>();
+            reference.Add(fish1);
+            fish1->SetLocation(x, y);
+            fish1->SetSpeed(speedX, speedY);
+            fishes1.push_back(fish1);
+
+            auto fish2 = aquarium.Create<FishBeta>();
+            aquarium.Add(fish2);
+            fish2->SetLocation(x, y);
+            fish2->SetSpeed(speedX, speedY);
+            fishes2.push_back(fish2);
+        }
+
+        for (int step = 0; step < 1000; step++)
+        {
+            for (auto fish : fishes1)
+            {
+                fish->Update(Elapsed);
+            }
+
+            aquarium.Update(Elapsed);
+        }
+
+        for (int i = 0; i < NumFish; i++)
+        {
+            ASSERT_EQ(fishes1[i]->GetX(), fishes2[i]->GetX());
+            ASSERT_EQ(fishes1[i]->GetY(), fishes2[i]->GetY());
+            ASSERT_EQ(fishes1[i]->GetSpeedX(), fishes2[i]->GetSpeedX());
+            ASSERT_EQ(fishes1[i]->GetSpeedY(), fishes2[i]->GetSpeedY());
+            ASSERT_EQ(fishes1[i]->GetMirror(), fishes2[i]->GetMirror());
+        }
+    }
+}
+
+TEST(KinematicsTest, FixedStep){
+    Aquarium aquarium;
+    auto &kinematics = aquarium.GetKinematics();
+
+    auto fish = aquarium.Create<FishBeta>();
+    aquarium.Add(fish);
+    fish->SetLocation(500, 400);
+    fish->SetSpeed(120, 0);
+
+    // At 120 steps per second the fish moves one pixel a
+    // step. 3.5 steps of time is three steps, with the fish
+    // drawn half way through the last one.
+    aquarium.Advance(3.5 / 120);
+    ASSERT_NEAR(503, fish->GetX(), 0.0001);
+    ASSERT_NEAR(502.5, kinematics.DrawX(fish->GetSlot()), 0.0001);
+
+    // The left over half step is not lost
+    aquarium.Advance(0.75 / 120);
+    ASSERT_NEAR(504, fish->GetX(), 0.0001);
+    ASSERT_NEAR(503.25, kinematics.DrawX(fish->GetSlot()), 0.0001);
+
+    // A long stall only catches up a few steps
+    aquarium.Advance(10);
+    ASSERT_NEAR(512, fish->GetX(), 0.0001);
+
+    // Moving an item draws it there at once
+    fish->SetLocation(300, 300);
+    ASSERT_NEAR(300, kinematics.DrawX(fish->GetSlot()), 0.0001);
+}
+
+TEST(KinematicsTest, ParallelUpdate){
+    const int NumFish = 1000;
+    const double Elapsed = 1.0 / 60;
+
+    // The same tank updated serially and on several threads
+    Aquarium serial;
+    Aquarium parallel;
+    parallel.SetUpdateThreads(4);
+    parallel.SetGrainSize(37);
+    ASSERT_EQ(4, parallel.GetUpdateThreads());
+
+    std::mt19937 random(5678);
+    std::uniform_real_distribution<double> location(100, 700);
+    std::uniform_real_distribution<double> speed(-400, 400);
+
+    vector<FishBeta*> fishes1;
+    vector<FishBeta*> fishes2;
+    for (int i = 0; i < NumFish; i++)
+    {
+        double x = location(random), y = location(random);
+        double speedX = speed(random), speedY = speed(random);
+
+        auto fish1 = serial.Create<FishBeta>();
+        serial.Add(fish1);
+        fish1->SetLocation(x, y);
+        fish1->SetSpeed(speedX, speedY);
+        fishes1.push_back(fish1);
+
+        auto fish2 = parallel.Create<FishBeta>();
+        parallel.Add(fish2);
+        fish2->SetLocation(x, y);
+        fish2->SetSpeed(speedX, speedY);
+        fishes2.push_back(fish2);
+    }
+
+    for (int step = 0; step < 200; step++)
+    {
+        serial.Update(Elapsed);
+        parallel.Update(Elapsed);
+    }
+
+    for (int i = 0; i < NumFish; i++)
+    {
+        ASSERT_EQ(fishes1[i]->GetX(), fishes2[i]->GetX());
+        ASSERT_EQ(fishes1[i]->GetY(), fishes2[i]->GetY());
+        ASSERT_EQ(fishes1[i]->GetSpeedX(), fishes2[i]->GetSpeedX());
+        ASSERT_EQ(fishes1[i]->GetMirror(), fishes2[i]->GetMirror());
+    }
+
+    parallel.SetUpdateThreads(1);
+    ASSERT_EQ(1, parallel.GetUpdateThreads());
+}
@@ -0,0 +1,91 @@
+/**
+ * @file NumberTextTest.cpp
+ * @author joeyv
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <NumberText.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+
+using namespace std;
+
+/**
+ * Format a number and parse it back
+ * @param value Number to format
+ * @return The parsed number
+ */
+static double RoundTrip(double value)
+{
+    char buffer[NumberText::BufferSize];
+    double parsed = 0;
+    EXPECT_TRUE(NumberText::Parse(NumberText::Format(value, buffer), parsed));
+    return parsed;
+}
+
+TEST(NumberTextTest, Format){
+    char buffer[NumberText::BufferSize];
+
+    ASSERT_EQ("100", NumberText::Format(100, buffer));
+    ASSERT_EQ("-0.125", NumberText::Format(-0.125, buffer));
+    ASSERT_EQ("0.1", NumberText::Format(0.1, buffer));
+    ASSERT_EQ("1234567", NumberText::Format(1234567, buffer));
+    ASSERT_EQ("1e+20", NumberText::Format(1e20, buffer));
+    ASSERT_EQ("-2.2250738585072014e-308", NumberText::Format(-numeric_limits<double>::min(), buffer));
+}
+
+TEST(NumberTextTest, RoundTrip){
+    // Every bit of the value must survive, including the
+    // sign of zero and the smallest denormals
+    for (double value : {0.0, -0.0, 0.1, 1.0 / 3, 123.456, -1e-300,
+                         numeric_limits<double>::max(), numeric_limits<double>::lowest(),
+                         numeric_limits<double>::denorm_min(), numeric_limits<double>::epsilon()})
+    {
+        auto parsed = RoundTrip(value);
+        ASSERT_EQ(0, memcmp(&value, &parsed, sizeof(double))) << value;
+    }
+
+    mt19937_64 random(1234);
+    uniform_real_distribution<> location(-2000, 2000);
+    for (int i = 0; i < 100000; i++)
+    {
+        double value = location(random);
+        ASSERT_EQ(value, RoundTrip(value));
+
+        // Arbitrary bit patterns cover every exponent
+        uint64_t bits = random();
+        memcpy(&value, &bits, sizeof(double));
+        if (isfinite(value))
+        {
+            ASSERT_EQ(value, RoundTrip(value));
+        }
+    }
+}
+
+TEST(NumberTextTest, Parse){
+    double value = 42;
+
+    // Text written by wxString::FromDouble in older files
+    ASSERT_TRUE(NumberText::Parse("123.457", value));
+    ASSERT_EQ(123.457, value);
+    ASSERT_TRUE(NumberText::Parse("1.23457e+06", value));
+    ASSERT_EQ(1.23457e+06, value);
+    ASSERT_TRUE(NumberText::Parse("-2e3", value));
+    ASSERT_EQ(-2000, value);
+
+    ASSERT_TRUE(NumberText::Parse(" +7.5\n", value));
+    ASSERT_EQ(7.5, value);
+
+    // Failures leave the value alone
+    value = 42;
+    ASSERT_FALSE(NumberText::Parse("", value));
+    ASSERT_FALSE(NumberText::Parse("  ", value));
+    ASSERT_FALSE(NumberText::Parse("oops", value));
+    ASSERT_FALSE(NumberText::Parse("12px", value));
+    ASSERT_FALSE(NumberText::Parse("+", value));
+    ASSERT_FALSE(NumberText::Parse("1,5", value));
+    ASSERT_EQ(42, value);
+}
@@ -0,0 +1,74 @@
+/**
+ * @file OffscreenRendererTest.cpp
+ * @author joeyv
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <OffscreenRenderer.h>
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <DecorCastle.h>
+
+using namespace std;
+
+TEST(OffscreenRendererTest, Render){
+    Aquarium aquarium;
+    OffscreenRenderer renderer(aquarium.GetWidth(), aquarium.GetHeight());
+
+    renderer.Render(&aquarium);
+    auto empty = renderer.ReadPixels();
+    ASSERT_EQ((size_t)aquarium.GetWidth() * aquarium.GetHeight() * 4, empty.size());
+
+    auto fish = aquarium.Create<FishBeta>();
+    aquarium.Add(fish);
+    fish->SetLocation(500, 400);
+
+    renderer.Render(&aquarium);
+    auto &pixels = renderer.ReadPixels();
+
+    // The center of the fish is drawn over the background
+    auto center = ((size_t)400 * aquarium.GetWidth() + 500) * 4;
+    ASSERT_FALSE(equal(pixels.begin() + center, pixels.begin() + center + 3,
+            empty.begin() + center));
+
+    // Far away from the fish nothing changed
+    auto corner = ((size_t)700 * aquarium.GetWidth() + 50) * 4;
+    ASSERT_TRUE(equal(pixels.begin() + corner, pixels.begin() + corner + 4,
+            empty.begin() + corner));
+}
+
+TEST(OffscreenRendererTest, Decor){
+    Aquarium aquarium;
+    OffscreenRenderer renderer(aquarium.GetWidth(), aquarium.GetHeight());
+
+    renderer.Render(&aquarium);
+    auto empty = renderer.ReadPixels();
+
+    auto fish = aquarium.Create<FishBeta>();
+    aquarium.Add(fish);
+    fish->SetLocation(500, 400);
+    renderer.Render(&aquarium);
+    auto fishOnly = renderer.ReadPixels();
+
+    // Decor is drawn behind the fish even when added after it
+    auto castle = aquarium.Create<DecorCastle>();
+    aquarium.Add(castle);
+    castle->SetLocation(500, 400);
+    renderer.Render(&aquarium);
+    auto pixels = renderer.ReadPixels();
+
+    auto center = ((size_t)400 * aquarium.GetWidth() + 500) * 4;
+    ASSERT_TRUE(equal(pixels.begin() + center, pixels.begin() + center + 4,
+            fishOnly.begin() + center));
+
+    // Dragging the decor redraws it where it now is
+    auto castleCenter = ((size_t)300 * aquarium.GetWidth() + 200) * 4;
+    castle->SetLocation(200, 300);
+    renderer.Render(&aquarium);
+    pixels = renderer.ReadPixels();
+    ASSERT_FALSE(equal(pixels.begin() + castleCenter, pixels.begin() + castleCenter + 3,
+            empty.begin() + castleCenter));
+    ASSERT_TRUE(equal(pixels.begin() + center, pixels.begin() + center + 4,
+            fishOnly.begin() + center));
+}
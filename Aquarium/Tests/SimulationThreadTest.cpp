@@ -0,0 +1,59 @@
+/**
+ * @file SimulationThreadTest.cpp
+ * @author joeyv
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <SimulationThread.h>
+#include <SnapshotBuffer.h>
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <chrono>
+
+using namespace std;
+
+TEST(SimulationThreadTest, SnapshotBuffer){
+    SnapshotBuffer buffer;
+    ASSERT_TRUE(buffer.Acquire().empty());
+
+    buffer.GetWriteBuffer().assign(1, {nullptr, 1, 0, false});
+    buffer.Publish();
+    ASSERT_EQ(1, buffer.Acquire()[0].x);
+
+    // Only the latest of several snapshots is seen
+    buffer.GetWriteBuffer().assign(1, {nullptr, 2, 0, false});
+    buffer.Publish();
+    buffer.GetWriteBuffer().assign(1, {nullptr, 3, 0, false});
+    buffer.Publish();
+    ASSERT_EQ(3, buffer.Acquire()[0].x);
+
+    // With nothing new we keep the snapshot we have
+    ASSERT_EQ(3, buffer.Acquire()[0].x);
+    ASSERT_EQ(3, buffer.Acquire()[0].x);
+}
+
+TEST(SimulationThreadTest, Run){
+    Aquarium aquarium;
+    auto fish = aquarium.Create<FishBeta>();
+    aquarium.Add(fish);
+    fish->SetLocation(500, 400);
+    fish->SetSpeed(100, 0);
+
+    SimulationThread simulation(&aquarium);
+    simulation.Start();
+    ASSERT_TRUE(simulation.IsRunning());
+
+    // Edits made while holding the lock are safe
+    for (int i = 0; i < 10; i++)
+    {
+        this_thread::sleep_for(chrono::milliseconds(10));
+        lock_guard<mutex> lock(aquarium.GetMutex());
+        aquarium.Publish();
+    }
+
+    simulation.Stop();
+    ASSERT_FALSE(simulation.IsRunning());
+    ASSERT_GT(fish->GetX(), 500);
+    ASSERT_NEAR(400, fish->GetY(), 0.0001);
+}
@@ -0,0 +1,144 @@
+/**
+ * @file SpatialGridTest.cpp
+ * @author joeyv
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <SpatialGrid.h>
+#include <Aquarium.h>
+#include <FishBeta.h>
+
+using namespace std;
+
+TEST(SpatialGridTest, QueryPoint){
+    Aquarium aquarium;
+    SpatialGrid grid(256);
+
+    auto fish = aquarium.Create<FishBeta>();
+    fish->SetLocation(100, 200);
+    grid.Insert(fish);
+    ASSERT_EQ(1, grid.GetCount());
+
+    vector<Item*> result;
+    grid.QueryPoint(100, 200, result);
+    ASSERT_EQ(1, result.size());
+    ASSERT_EQ(fish, result[0]);
+
+    // Outside the bounding box of the fish
+    result.clear();
+    grid.QueryPoint(100 + 125 / 2 + 1, 200, result);
+    ASSERT_TRUE(result.empty());
+
+    // Move the fish into another cell
+    fish->SetLocation(1000, 1000);
+    grid.Move(fish, 100, 200);
+
+    result.clear();
+    grid.QueryPoint(100, 200, result);
+    ASSERT_TRUE(result.empty());
+
+    grid.QueryPoint(1000, 1000, result);
+    ASSERT_EQ(1, result.size());
+
+    ASSERT_TRUE(grid.Remove(fish, 1000, 1000));
+    ASSERT_EQ(0, grid.GetCount());
+}
+
+TEST(SpatialGridTest, QueryRadius){
+    Aquarium aquarium;
+    SpatialGrid grid(256);
+
+    vector<FishBeta*> fish;
+    for (int i = 0; i < 10; i++)
+    {
+        auto f = aquarium.Create<FishBeta>();
+        f->SetLocation(i * 100, 0);
+        grid.Insert(f);
+        fish.push_back(f);
+    }
+
+    vector<Item*> result;
+    grid.QueryRadius(450, 0, 100, result);
+    ASSERT_EQ(2, result.size());
+
+    ASSERT_TRUE(grid.AnyWithin(300, 0, 1));
+    ASSERT_FALSE(grid.AnyWithin(301, 0, 1));
+}
+
+TEST(SpatialGridTest, AquariumTracksMoves){
+    Aquarium aquarium;
+
+    auto fish = aquarium.Create<FishBeta>();
+    aquarium.Add(fish);
+
+    // Items moved after they are added are still found
+    fish->SetLocation(800, 600);
+    ASSERT_EQ(nullptr, aquarium.HitTest(200, 200));
+    ASSERT_TRUE(aquarium.HitTest(800, 600) == fish);
+
+    ASSERT_EQ(1, aquarium.ItemsNear(790, 590, 20).size());
+    ASSERT_TRUE(aquarium.ItemsNear(200, 200, 20).empty());
+
+    // Animation moves are tracked as well
+    fish->SetSpeed(-1000, 0);
+    aquarium.Update(0.4);
+    ASSERT_EQ(nullptr, aquarium.HitTest(800, 600));
+    ASSERT_TRUE(aquarium.HitTest(400, 600) == fish);
+}
+
+TEST(SpatialGridTest, FarLocations){
+    Aquarium aquarium;
+    SpatialGrid grid(100);
+
+    // Locations that do not fit a cell number go in the edge
+    // cells rather than overflowing
+    vector<Item *> fishes;
+    for (double x : {1e300, -1e300, numeric_limits<double>::infinity(), numeric_limits<double>::quiet_NaN()})
+    {
+        auto fish = aquarium.Create<FishBeta>();
+        fish->SetLocation(x, 0);
+        grid.Insert(fish);
+        fishes.push_back(fish);
+    }
+
+    vector<Item *> result;
+    grid.QueryPoint(1e300, 0, result);
+    ASSERT_NE(find(result.begin(), result.end(), fishes[0]), result.end());
+
+    result.clear();
+    grid.QueryPoint(0, 0, result);
+    ASSERT_TRUE(result.empty());
+
+    for (auto fish : fishes)
+    {
+        ASSERT_TRUE(grid.Remove(fish, fish->GetX(), 0));
+    }
+}
+
+TEST(SpatialGridTest, HugeQueries){
+    Aquarium aquarium;
+    SpatialGrid grid(256);
+
+    auto near = aquarium.Create<FishBeta>();
+    near->SetLocation(100, 100);
+    grid.Insert(near);
+
+    auto far = aquarium.Create<FishBeta>();
+    far->SetLocation(1e9, -1e9);
+    grid.Insert(far);
+
+    // These cover far more cells than could be walked one
+    // by one, so only the occupied cells are looked at
+    vector<Item *> result;
+    grid.QueryRadius(0, 0, 1e12, result);
+    ASSERT_EQ(2, result.size());
+
+    result.clear();
+    grid.QueryRect(-1e12, -1e12, 1e12, 0, result);
+    ASSERT_EQ(1, result.size());
+    ASSERT_EQ(far, result[0]);
+
+    ASSERT_TRUE(grid.AnyWithin(0, 0, 1e10));
+    ASSERT_FALSE(grid.AnyWithin(5e8, 5e8, 1e8));
+}
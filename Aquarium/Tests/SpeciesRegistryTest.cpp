@@ -0,0 +1,67 @@
+/**
+ * @file SpeciesRegistryTest.cpp
+ * @author joeyv
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <SpeciesRegistry.h>
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <DecorCastle.h>
+
+using namespace std;
+
+TEST(SpeciesRegistryTest, Find){
+    auto &registry = SpeciesRegistry::Instance();
+    ASSERT_EQ(4, registry.GetCount());
+
+    for (auto type : {"beta", "sparty", "stinky", "castle"})
+    {
+        auto species = registry.Find(type);
+        ASSERT_NE(nullptr, species);
+        ASSERT_EQ(type, species->GetType());
+        ASSERT_EQ(species, &registry.GetSpecies(species->GetIndex()));
+    }
+
+    // Lookups with a tag that is not the interned one
+    // still find the interned species
+    string beta = "beta";
+    ASSERT_EQ(registry.Find("beta"), registry.Find(beta));
+
+    ASSERT_EQ(nullptr, registry.Find("carp"));
+    ASSERT_EQ(nullptr, registry.Find(""));
+    ASSERT_THROW(registry.Get("carp"), out_of_range);
+}
+
+TEST(SpeciesRegistryTest, Menus){
+    auto &registry = SpeciesRegistry::Instance();
+
+    ASSERT_EQ(Species::Menu::Fish, registry.Get("beta").GetMenu());
+    ASSERT_EQ(Species::Menu::Decor, registry.Get("castle").GetMenu());
+    ASSERT_EQ(L"&Castle", registry.Get("castle").GetName());
+    ASSERT_EQ(L"images/castle.png", registry.Get("castle").GetImage());
+}
+
+TEST(SpeciesRegistryTest, Create){
+    Aquarium aquarium;
+    auto &registry = SpeciesRegistry::Instance();
+
+    for (int i = 0; i < registry.GetCount(); i++)
+    {
+        auto &species = registry.GetSpecies(i);
+        auto item = species.Create(&aquarium);
+
+        ASSERT_EQ(&species, item->GetSpecies());
+        ASSERT_EQ(species.GetType(), item->GetType());
+        ASSERT_EQ(species.GetSprite().get(), item->GetSprite());
+    }
+
+    // Items made directly are of the registered species too
+    auto fish = aquarium.Create<FishBeta>();
+    ASSERT_EQ(registry.Find("beta"), fish->GetSpecies());
+
+    auto castle = aquarium.Create<DecorCastle>();
+    ASSERT_EQ("castle", castle->GetType());
+    ASSERT_FALSE(castle->IsAnimated());
+}
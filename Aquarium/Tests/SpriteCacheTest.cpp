@@ -0,0 +1,49 @@
+/**
+ * @file SpriteCacheTest.cpp
+ * @author joeyv
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <SpriteCache.h>
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <SpartyFish.h>
+
+using namespace std;
+
+TEST(SpriteCacheTest, SharedBetweenItems){
+    Aquarium aquarium;
+
+    auto fish1 = aquarium.Create<FishBeta>();
+    auto fish2 = aquarium.Create<FishBeta>();
+    auto fish3 = aquarium.Create<SpartyFish>();
+
+    // Fish of the same species share one sprite
+    ASSERT_EQ(fish1->GetSprite(), fish2->GetSprite());
+
+    // Different species get different sprites
+    ASSERT_NE(fish1->GetSprite(), fish3->GetSprite());
+}
+
+TEST(SpriteCacheTest, Released){
+    auto &cache = SpriteCache::Instance();
+    Aquarium aquarium;
+
+    auto loaded = cache.GetLoadedCount();
+    aquarium.Create<FishBeta>();
+    aquarium.Create<FishBeta>();
+    ASSERT_EQ(loaded + 1, cache.GetLoadedCount());
+
+    // Once the aquarium lets go of its fish the sprite is released
+    aquarium.Clear();
+    ASSERT_EQ(loaded, cache.GetLoadedCount());
+
+    {
+        Aquarium other;
+        other.Create<FishBeta>();
+        ASSERT_EQ(loaded + 1, cache.GetLoadedCount());
+    }
+
+    ASSERT_EQ(loaded, cache.GetLoadedCount());
+}
@@ -0,0 +1,163 @@
+/**
+ * @file TankFileTest.cpp
+ * @author joeyv
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include "TestFiles.h"
+#include <TankFile.h>
+#include <wx/filename.h>
+#include <fstream>
+
+using namespace std;
+
+class TankFileTest : public ::testing::Test {
+protected:
+    /**
+     * Write a large .aqua file of items in three species
+     * @param filename File to write
+     * @param count Number of items
+     * @param nested Items to put in a nested element in the
+     * middle of the file, which a parallel read cannot split
+     */
+    void WriteTank(const wxString &filename, int count, int nested = 0)
+    {
+        ofstream file(filename.ToStdString(), ios::binary);
+        file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<aqua>";
+        for (int i = 0; i < count; i++)
+        {
+            if (i == count / 2)
+            {
+                file << "<group>";
+                for (int j = 0; j < nested; j++)
+                {
+                    file << "<item x=\"-1\" y=\"-1\" type=\"nested\"/>";
+                }
+                file << "</group>";
+            }
+
+            file << "<item x=\"" << i << ".25\" y=\"" << -i << "\"";
+            if (i % 3 != 2)
+            {
+                file << " x-speed=\"" << i % 100 << "\" y-speed=\"7\"";
+            }
+            file << " type=\"" << (i % 3 == 0 ? "beta" : i % 3 == 1 ? "sparty" : "castle") << "\"/>\n";
+        }
+        file << "</aqua>\n";
+    }
+
+    /**
+     * Expect two reads of a file to have the same contents
+     * @param expected Data from one read
+     * @param actual Data from the other read
+     */
+    void ExpectSame(const TankData &expected, const TankData &actual)
+    {
+        ASSERT_EQ(expected.species.size(), actual.species.size());
+        for (size_t i = 0; i < expected.species.size(); i++)
+        {
+            ASSERT_EQ(expected.species[i].type, actual.species[i].type);
+            ASSERT_EQ(expected.species[i].moving, actual.species[i].moving);
+        }
+
+        ASSERT_EQ(expected.items.size(), actual.items.size());
+        for (size_t i = 0; i < expected.items.size(); i++)
+        {
+            ASSERT_EQ(expected.items[i].x, actual.items[i].x);
+            ASSERT_EQ(expected.items[i].y, actual.items[i].y);
+            ASSERT_EQ(expected.items[i].speedX, actual.items[i].speedX);
+            ASSERT_EQ(expected.items[i].speedY, actual.items[i].speedY);
+            ASSERT_EQ(expected.items[i].species, actual.items[i].species);
+        }
+    }
+};
+
+TEST_F(TankFileTest, ParallelRead){
+    // Enough items for the file to be split into several pieces
+    const int NumItems = 200000;
+
+    auto filename = TempPath(L"tank1.aqua");
+    WriteTank(filename, NumItems);
+
+    TankData serial;
+    ASSERT_TRUE(TankFile::Read(filename, serial));
+    ASSERT_EQ(NumItems, serial.items.size());
+    ASSERT_EQ(3, serial.species.size());
+    ASSERT_EQ("castle", serial.species[2].type);
+    ASSERT_FALSE(serial.species[2].moving);
+
+    double last = 0;
+    TankData parallel;
+    ASSERT_TRUE(TankFile::Read(filename, parallel, [&last](double progress) {
+        last = progress;
+        return true;
+    }, 4));
+    ASSERT_GT(last, 0);
+    ExpectSame(serial, parallel);
+
+    // Cancelling stops the read
+    ASSERT_FALSE(TankFile::Read(filename, parallel, [](double progress) { return false; }, 4));
+}
+
+TEST_F(TankFileTest, ParallelFallback){
+    const int NumItems = 200000;
+
+    // Items nested in another element are not split correctly,
+    // so these files are read serially with the same result
+    auto filename = TempPath(L"tank2.aqua");
+    for (int nested : {10, 100000})
+    {
+        WriteTank(filename, NumItems, nested);
+
+        TankData serial;
+        ASSERT_TRUE(TankFile::Read(filename, serial));
+        ASSERT_EQ(NumItems, serial.items.size());
+
+        TankData parallel;
+        ASSERT_TRUE(TankFile::Read(filename, parallel, nullptr, 4));
+        ExpectSame(serial, parallel);
+    }
+}
+
+TEST_F(TankFileTest, Unusable){
+    auto filename = TempPath(L"tank3.aqua");
+    for (auto value : {"nan", "inf", "-inf", "1e300"})
+    {
+        for (auto attribute : {"x", "y-speed"})
+        {
+            {
+                ofstream file(filename.ToStdString(), ios::binary);
+                file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<aqua>"
+                     << "<item x=\"100\" y=\"200\" type=\"beta\"/>"
+                     << "<item " << attribute << "=\"" << value << "\" type=\"beta\"/></aqua>\n";
+            }
+
+            TankData data;
+            ASSERT_FALSE(TankFile::Read(filename, data)) << attribute << "=" << value;
+        }
+    }
+
+    // A large file read in parallel is rejected too
+    const int NumItems = 200000;
+    {
+        ofstream file(filename.ToStdString(), ios::binary);
+        file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<aqua>";
+        for (int i = 0; i < NumItems; i++)
+        {
+            file << "<item x=\"" << (i == NumItems / 2 ? "nan" : "10") << "\" y=\"20\" type=\"beta\"/>\n";
+        }
+        file << "</aqua>\n";
+    }
+
+    TankData data;
+    ASSERT_FALSE(TankFile::Read(filename, data, nullptr, 4));
+
+    // So is a binary file
+    data.species.push_back(TankSpecies{"beta", true});
+    data.items.resize(1);
+    data.items[0].speedX = numeric_limits<double>::infinity();
+    auto binary = TempPath(L"tank3.tank");
+    ASSERT_TRUE(TankFile::Write(binary, data, TankFile::Format::Binary));
+    ASSERT_FALSE(TankFile::Read(binary, data));
+}
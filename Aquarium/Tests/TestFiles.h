@@ -0,0 +1,67 @@
+/**
+ * @file TestFiles.h
+ * @author joeyv
+ *
+ * Temporary files for the tests.
+ */
+
+#ifndef AQUARIUM_TESTFILES_H
+#define AQUARIUM_TESTFILES_H
+
+#include <wx/filename.h>
+#include <wx/utils.h>
+#include "gtest/gtest.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+
+/**
+ * Get a path in the temporary directory for the running test.
+ *
+ * The file name starts with the test suite, the test and the
+ * process id, so tests run at the same time, in one process
+ * or several, never use each other's files.
+ *
+ * @param name Name of the file within the test
+ * @return Path to the file
+ */
+inline wxString TempPath(const wxString &name)
+{
+    auto path = wxFileName::GetTempDir() + L"/aquarium";
+    if(!wxFileName::DirExists(path))
+    {
+        wxFileName::Mkdir(path, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+    }
+
+    auto test = ::testing::UnitTest::GetInstance()->current_test_info();
+    wxString prefix = test != nullptr ?
+            wxString::Format(L"%s.%s-", test->test_suite_name(), test->name()) : wxString();
+
+    return path + L"/" + prefix + wxString::Format(L"%lu-", wxGetProcessId()) + name;
+}
+
+/**
+ * Read a file into a string
+ * @param filename File to read
+ * @return File contents
+ */
+inline std::string ReadFile(const wxString &filename)
+{
+    std::ifstream file(filename.ToStdString(), std::ios::binary);
+    std::stringstream stream;
+    stream << file.rdbuf();
+    return stream.str();
+}
+
+/**
+ * Write text to a file
+ * @param filename File to write
+ * @param text Text to write
+ */
+inline void WriteFile(const wxString &filename, const std::string &text)
+{
+    std::ofstream file(filename.ToStdString(), std::ios::binary);
+    file << text;
+}
+
+#endif //AQUARIUM_TESTFILES_H
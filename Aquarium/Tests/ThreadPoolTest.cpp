@@ -0,0 +1,40 @@
+/**
+ * @file ThreadPoolTest.cpp
+ * @author joeyv
+ */
+
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <ThreadPool.h>
+
+using namespace std;
+
+TEST(ThreadPoolTest, ParallelFor){
+    ThreadPool pool(4);
+    ASSERT_EQ(4, pool.GetThreadCount());
+
+    // Every item is visited exactly once, loop after loop
+    vector<int> visits(10007, 0);
+    for (int loop = 0; loop < 20; loop++)
+    {
+        pool.ParallelFor(0, (int)visits.size(), 100, [&](int begin, int end) {
+            for (int i = begin; i < end; i++)
+            {
+                visits[i]++;
+            }
+        });
+    }
+
+    for (auto count : visits)
+    {
+        ASSERT_EQ(20, count);
+    }
+
+    // Ranges smaller than a chunk run on the calling thread
+    auto caller = this_thread::get_id();
+    pool.ParallelFor(5, 10, 100, [&](int begin, int end) {
+        ASSERT_EQ(caller, this_thread::get_id());
+        ASSERT_EQ(5, begin);
+        ASSERT_EQ(10, end);
+    });
+}